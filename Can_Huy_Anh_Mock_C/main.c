@@ -3,137 +3,231 @@
 *******************************************************************************/
 
 #include "sreclib.h" 
+#include "srecpipe.h"
+#include "srecblock.h"
+#include "srecpage.h"
+#include "srecverify.h"
+#include "srecfollow.h"
+#include "srecserve.h"
+#include "srecrepair.h"
+#include "srecfast.h"
+#include "srecinput.h"
+#include <stdlib.h>
+#include <time.h>
 /* Define a macro for test program mode (set to 0 for normal mode). */
 #define TEST_PROGRAM 0
 /*******************************************************************************
 * Function
 *******************************************************************************/
 /* Function to print the S-record data to the output file and to the console. */
-static void printDataSrec(FILE* output, uint32_t lineNumber, const char* add, const char* data, const char* error)
+static void printDataSrec(FILE* output, const SrecRecord* record)
 {
-    fprintf(output, "%-10u %-10s %-70s %-20s\n", lineNumber, add, data, error);  
-    printf("%-10u %-10s %-70s %-20s\n", lineNumber, add, data, error);  
+    PrintSrecRecord(output, record);
+    PrintSrecRecord(stdout, record);
 }
 
-/* Function to parse S-records from an input file and write results to an output file. */
-static void parseSrecord(const char* inputFile, const char* outputFile)
+/* Function to parse S-records from an input file and write results to an output file.
+ * Data records outside [firstAddress, lastAddress] are skipped after decoding their address.
+ * Returns 1 if the whole input was parsed, 0 otherwise. */
+static uint8_t parseSrecord(const char* inputFile, const char* outputFile, uint32_t firstAddress, uint32_t lastAddress)
 {
     char line[LENGTH_OF_LINE];  /* Buffer to hold each line read from the input file. */
-    uint32_t numberOfLine;  /* Current line number in the input file. */
+    SrecRecord record;  /* Line number, fields and error message of the current line. */
+    uint32_t numberOfData;  /* Number of data records (S1/S2/S3) read so far. */
     SrecTpye stype;  /* Type of S-record (S1, S2, etc.). */
-    char errorMessage[255];  /* Buffer to hold error messages. */
-    char address[10];  /* Buffer to hold the address field of the S-record. */
-    char data[255];  /* Buffer to hold the data field of the S-record. */
-    uint32_t lengthOfAddress;  /* Length of the address field based on S-record type. */
-    uint32_t lengthOfData;  /* Length of the data field in the S-record. */
     DataRecordType typeOfData;  /* Type of data record being processed. */
-    FILE* srecfile = fopen(inputFile, "r");  /* File pointer for reading S-records. */
+    SrecRecordChecker checkRecord;  /* Line checker specialized for typeOfData. */
+    uint8_t Flag;  /* 1 if the whole input was parsed. */
+    SrecInput* srecfile = OpenSrecInput(inputFile);  /* Input for reading S-records, plain or gzip-compressed. */
     FILE* output = fopen(outputFile, "w");  /* File pointer for writing output. */
-    uint16_t index;  /* Loop index for character processing. */
-    uint32_t lengthOfLine;  /* Length of the current line being processed. */
 
     if ((srecfile == NULL) || (output == NULL))
     {
         perror("ERROR: Can't open this file");  /* Print error if file opening fails. */
-        return;
+        CloseSrecInput(srecfile);
+        if (output != NULL)
+        {
+            fclose(output);
+        }
+        return 0;
     }
     else
     {
-        numberOfLine = 0;  /* Initialize line number counter. */
-        typeOfData = CheckDataRecord(srecfile);  /* Determine the type of data record. */
-        rewind(srecfile);  /* Rewind file to the beginning for processing. */
+        record.numberOfLine = 0;  /* Initialize line number counter. */
+        numberOfData = 0;  /* Initialize data record counter. */
+        typeOfData = CheckDataRecordInput(srecfile);  /* Determine the type of data record. */
+        checkRecord = GetSrecRecordChecker(typeOfData);  /* Select the checker once for the whole file. */
+        if (RewindSrecInput(srecfile) != 1)  /* Rewind file to the beginning for processing. */
+        {
+            fprintf(stderr, "ERROR: Can't rewind the input\n");
+            CloseSrecInput(srecfile);
+            fclose(output);
+            return 0;
+        }
 
         /* Print headers for the output file and console. */
-        fprintf(output, "%-10s %-10s %-70s %-8s\n", "LINE", "ADDRESS", "DATA", "ERROR MESSAGE");
-        printf("%-10s %-10s %-70s %-8s\n", "LINE", "ADDRESS", "DATA", "ERROR MESSAGE");
+        PrintSrecHeader(output);
+        PrintSrecHeader(stdout);
 
         /* Process each line in the input file. */
-        while (fgets(line, sizeof(line), srecfile) != NULL)
+        while (GetsSrecInput(line, sizeof(line), srecfile) != NULL)
         {
-            numberOfLine++;  /* Increment line number. */
-            strcpy(errorMessage, "Valid");  /* Initialize error message as "Valid". */
-            lengthOfLine = (uint32_t)strlen(line);  /* Get the length of the current line. */
-
-            /* Remove trailing newline character if present. */
-            if (line[lengthOfLine - 1] == '\n')
-            {
-                line[lengthOfLine - 1] = '\0';
-                lengthOfLine--;
-            }
+            record.numberOfLine++;  /* Increment line number. */
+            record.numberOfData = numberOfData;  /* Data records before this line, used by S5/S6. */
 
             stype = CheckSType(line);  /* Determine the type of S-record. */
-
-            /* Determine the length of the address field based on the S-record type. */
-            if (typeOfData == S1_TYPE || stype == S5)
-            {
-                lengthOfAddress = 4;
-            }
-            else if (typeOfData == S2_TYPE)
+            if ((stype == S1) || (stype == S2) || (stype == S3))
             {
-                lengthOfAddress = 6;
-            }
-            else
-            {
-                lengthOfAddress = 8;
-            }
+                numberOfData++;
 
-            /* Check for various validation errors. */
-            if (stype == INVALID)
-            {
-                strcpy(errorMessage, "Invalid: Wrong S-type");
-            }
-            else if ((numberOfLine == 1) && (CheckSrecStart(line) != 1))
-            {
-                strcpy(errorMessage, "Invalid: First line is not S0 type.");
-            }
-            else if ((stype != typeOfData))
-            {
-                if (stype == S0 || stype == S9 || stype == S5 || stype == S8 || stype == S7 || stype == S6)
-                {
-                    /* No specific action for these S-types in this condition. */
-                }
-                else
+                /* Skip data records outside the address window without validating them.
+                 * A record of another type than the file is always checked to report it. */
+                if (((uint32_t)stype == (uint32_t)typeOfData) &&
+                    (CheckSrecWindow(line, GetAddressLength(stype) * 2, firstAddress, lastAddress) != 1))
                 {
-                    strcpy(errorMessage, "Invalid: Asynchronous S-type");
+                    continue;
                 }
             }
-            else if (CheckHexaLine(line, lengthOfLine) != 1)
-            {
-                strcpy(errorMessage, "Invalid: The line has a non-hexadecimal character");
-            }
-            else if (CheckByteCountSrec(line, lengthOfLine) != 1)
-            {
-                strcpy(errorMessage, "Invalid: Wrong byte count");
-            }
-            else if (CheckSumSrec(line) != 1)
-            {
-                strcpy(errorMessage, "Invalid: Checksum error");
-            }
-            else if (((stype == S5) || (stype == S6)) && (CheckLineCount(srecfile) != 1))
-            {
-                strcpy(errorMessage, "Invalid: Linecount error");
-            }
-            else if (((stype == S9)||(stype == S8)||(stype==S7)) && (CheckSrecTerminate(line, typeOfData) != 1))
-            {
-                strcpy(errorMessage, "Invalid: Terminate error");
-            }
-            
 
-            /* Extract address and data fields from the line. */
-            strncpy(address, line + 4, lengthOfAddress);
-            address[lengthOfAddress] = '\0';
-            lengthOfData = lengthOfLine - lengthOfAddress - 4 - 2;
-            strncpy(data, line + 4 + lengthOfAddress, lengthOfData);
-            data[lengthOfData] = '\0';
+            /* Validate the line and extract address and data fields. */
+            checkRecord(line, &record);
 
             /* Print the extracted data and error message. */
-            printDataSrec(output, numberOfLine, address, data, errorMessage);
+            printDataSrec(output, &record);
         }
     }
 
-    fclose(srecfile);  /* Close the input file. */
+    /* A corrupt or truncated input ends early, mark the report as incomplete. */
+    Flag = CheckSrecInput(srecfile);
+    if (Flag != 1)
+    {
+        fprintf(output, "ERROR: Input ends early, the report is incomplete\n");
+        fprintf(stdout, "ERROR: Input ends early, the report is incomplete\n");
+    }
+
+    CloseSrecInput(srecfile);  /* Close the input file. */
     fclose(output);  /* Close the output file. */
+
+    return Flag;
+}
+
+#if (TEST_PROGRAM == 1)
+/* Function to compare the time per line of the generic and the specialized line checkers. */
+static uint8_t benchSrecord(const char* inputFile, uint32_t iterations)
+{
+    char buffer[LENGTH_OF_LINE];  /* Buffer to count the lines of the file. */
+    char (*line)[LENGTH_OF_LINE];  /* Lines of the file, kept in memory so only the checks are timed. */
+    SrecRecord generic;  /* Result of the generic checker. */
+    SrecRecord special;  /* Result of the specialized checker. */
+    SrecRecordChecker checkRecord;  /* Line checker specialized for typeOfData. */
+    DataRecordType typeOfData;  /* Type of data record of the file. */
+    struct timespec start;  /* Start time of a measure. */
+    struct timespec stop;  /* Stop time of a measure. */
+    double genericTime;  /* Nanoseconds per line of the generic checker. */
+    double specialTime;  /* Nanoseconds per line of the specialized checker. */
+    uint32_t numberOfLine;  /* Number of lines of the file. */
+    uint32_t iteration;  /* Loop index over the iterations. */
+    uint32_t index;  /* Loop index over the lines. */
+    FILE* srecfile;  /* File pointer for reading S-records. */
+
+    if (iterations == 0)
+    {
+        fprintf(stderr, "ERROR: Number of iterations must be at least 1\n");
+        return 0;
+    }
+
+    srecfile = fopen(inputFile, "r");
+    if (srecfile == NULL)
+    {
+        perror("ERROR: Can't open this file");
+        return 0;
+    }
+
+    /* Load the lines, the checkers remove the newline in place so every iteration sees the same input. */
+    typeOfData = CheckDataRecord(srecfile);
+    rewind(srecfile);
+    numberOfLine = 0;
+    while (fgets(buffer, sizeof(buffer), srecfile) != NULL)
+    {
+        numberOfLine++;
+    }
+    if (numberOfLine == 0)
+    {
+        fprintf(stderr, "ERROR: %s has no line to check\n", inputFile);
+        fclose(srecfile);
+        return 0;
+    }
+    rewind(srecfile);
+    line = (char (*)[LENGTH_OF_LINE])malloc(sizeof(*line) * numberOfLine);
+    if (line == NULL)
+    {
+        fclose(srecfile);
+        return 0;
+    }
+    index = 0;
+    while ((index < numberOfLine) && (fgets(line[index], LENGTH_OF_LINE, srecfile) != NULL))
+    {
+        index++;
+    }
+    fclose(srecfile);
+    if (index != numberOfLine)
+    {
+        fprintf(stderr, "ERROR: %s changed while it was read\n", inputFile);
+        free(line);
+        return 0;
+    }
+    checkRecord = GetSrecRecordChecker(typeOfData);
+
+    /* Both checkers must agree on every line. */
+    for (index = 0; index < numberOfLine; index++)
+    {
+        generic.numberOfLine = index + 1;
+        generic.numberOfData = 0;
+        special = generic;
+        CheckSrecRecord(line[index], typeOfData, &generic);
+        checkRecord(line[index], &special);
+        if ((strcmp(generic.errorMessage, special.errorMessage) != 0) ||
+            (strcmp(generic.address, special.address) != 0) || (strcmp(generic.data, special.data) != 0))
+        {
+            fprintf(stderr, "ERROR: Checkers differ on line %u\n", index + 1);
+            free(line);
+            return 0;
+        }
+    }
+
+    timespec_get(&start, TIME_UTC);
+    for (iteration = 0; iteration < iterations; iteration++)
+    {
+        for (index = 0; index < numberOfLine; index++)
+        {
+            generic.numberOfLine = index + 1;
+            CheckSrecRecord(line[index], typeOfData, &generic);
+        }
+    }
+    timespec_get(&stop, TIME_UTC);
+    genericTime = ((stop.tv_sec - start.tv_sec) * 1e9 + (stop.tv_nsec - start.tv_nsec)) / ((double)iterations * numberOfLine);
+
+    timespec_get(&start, TIME_UTC);
+    for (iteration = 0; iteration < iterations; iteration++)
+    {
+        for (index = 0; index < numberOfLine; index++)
+        {
+            special.numberOfLine = index + 1;
+            checkRecord(line[index], &special);
+        }
+    }
+    timespec_get(&stop, TIME_UTC);
+    specialTime = ((stop.tv_sec - start.tv_sec) * 1e9 + (stop.tv_nsec - start.tv_nsec)) / ((double)iterations * numberOfLine);
+
+    printf("%-12s %10.1f ns/line\n", "generic", genericTime);
+    printf("%-12s %10.1f ns/line\n", "specialized", specialTime);
+    printf("%-12s %10.2fx\n", "speedup", (specialTime > 0) ? (genericTime / specialTime) : 0.0);
+
+    free(line);
+
+    return 1;
 }
+#endif
 
 /*******************************************************************************
 * Main
@@ -142,10 +236,74 @@ static void parseSrecord(const char* inputFile, const char* outputFile)
 int main(int argc, char* argv[])
 {
 #if (TEST_PROGRAM == 1)
+    /* Select the pipelined parser when the first argument is -pipeline. */
+    if ((argc == 5) && (strcmp(argv[1], "-pipeline") == 0))
+    {
+        /* Parse with a reader thread, <threads> validator threads and a writer. */
+        return (ParseSrecPipeline(argv[3], argv[4], (uint32_t)strtoul(argv[2], NULL, 10)) == 1) ? 0 : 1;
+    }
+
+    /* Merge contiguous data records into records of up to <bytes> data bytes. */
+    if ((argc == 5) && (strcmp(argv[1], "-reblock") == 0))
+    {
+        return (ReblockSrec(argv[3], argv[4], (uint32_t)strtoul(argv[2], NULL, 10)) == 1) ? 0 : 1;
+    }
+
+    /* List the dirty flash sectors and fill-padded pages touched by the data. */
+    if ((argc == 6) && (strcmp(argv[1], "-pages") == 0))
+    {
+        return (PageSrec(argv[4], argv[5], (uint32_t)strtoul(argv[2], NULL, 0), (uint32_t)strtoul(argv[3], NULL, 0)) == 1) ? 0 : 1;
+    }
+
+    /* Validate and report only the data records overlapping [first, last]. */
+    if ((argc == 6) && (strcmp(argv[1], "-window") == 0))
+    {
+        return (parseSrecord(argv[4], argv[5], (uint32_t)strtoul(argv[2], NULL, 16), (uint32_t)strtoul(argv[3], NULL, 16)) == 1) ? 0 : 1;
+    }
+
+    /* Compare the data records with a raw dump of the device starting at <base address>. */
+    if ((argc == 5) && (strcmp(argv[1], "-verify") == 0))
+    {
+        return (VerifySrecDump(argv[3], argv[4], (uint32_t)strtoul(argv[2], NULL, 16), stdout) == 1) ? 0 : 1;
+    }
+
+    /* Validate a growing file, only reading the lines appended since the last check. */
+    if ((argc == 5) && (strcmp(argv[1], "-follow") == 0))
+    {
+        return (FollowSrec(argv[3], argv[4], (uint32_t)strtoul(argv[2], NULL, 10)) == 1) ? 0 : 1;
+    }
+
+    /* Stay resident and answer requests on a local socket until SHUTDOWN. */
+    if ((argc == 3) && (strcmp(argv[1], "-serve") == 0))
+    {
+        return (ServeSrec(argv[2]) == 1) ? 0 : 1;
+    }
+
+    /* Fix byte count, S5/S6 count and checksum fields in place, logging the changes. */
+    if ((argc == 3) && (strcmp(argv[1], "-repair") == 0))
+    {
+        return (RepairSrec(argv[2], stdout) == 1) ? 0 : 1;
+    }
+
+    /* Time the generic and the specialized line checkers on the lines of a file. */
+    if ((argc == 4) && (strcmp(argv[1], "-bench") == 0))
+    {
+        return (benchSrecord(argv[3], (uint32_t)strtoul(argv[2], NULL, 10)) == 1) ? 0 : 1;
+    }
+
     /* Check if the correct number of command-line arguments are provided. */
     if (argc != 3)
     {
         fprintf(stderr, "Usage: %s <input file> <output file>\n", argv[0]);
+        fprintf(stderr, "       %s -pipeline <threads> <input file> <output file>\n", argv[0]);
+        fprintf(stderr, "       %s -reblock <bytes> <input file> <output file>\n", argv[0]);
+        fprintf(stderr, "       %s -pages <page size> <sector size> <input file> <output file>\n", argv[0]);
+        fprintf(stderr, "       %s -window <first address> <last address> <input file> <output file>\n", argv[0]);
+        fprintf(stderr, "       %s -verify <base address> <input file> <dump file>\n", argv[0]);
+        fprintf(stderr, "       %s -follow <idle seconds> <input file> <output file>\n", argv[0]);
+        fprintf(stderr, "       %s -serve <socket path>\n", argv[0]);
+        fprintf(stderr, "       %s -repair <file>\n", argv[0]);
+        fprintf(stderr, "       %s -bench <iterations> <input file>\n", argv[0]);
         return 1;
     }
 
@@ -155,9 +313,8 @@ int main(int argc, char* argv[])
     const char* inputFile = "Srecord_1.txt";  /* Default input file name for testing. */
     const char* outputFile = "Output.txt";  /* Default output file name for testing. */
 #endif
-    parseSrecord(inputFile, outputFile);  /* Call the parseSrecord function with provided file names. */
-
-    return 0;  /* Return success status. */
+    /* Call the parseSrecord function with provided file names, return its status. */
+    return (parseSrecord(inputFile, outputFile, 0, UINT32_MAX) == 1) ? 0 : 1;
 }
 
 
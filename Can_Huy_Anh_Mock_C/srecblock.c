@@ -0,0 +1,245 @@
+/*******************************************************************************
+* Include
+*******************************************************************************/
+
+#include "srecblock.h"
+
+/*******************************************************************************
+* Struct
+*******************************************************************************/
+
+/**
+ * @brief: State of the re-blocking pass
+ */
+typedef struct
+{
+    FILE* output;               /**< File receiving the re-blocked records */
+    uint32_t maxLengthOfData;   /**< Maximum number of data bytes requested per record */
+    SrecData pending;           /**< Data record being filled, empty when lengthOfData is 0 */
+    uint32_t numberOfData;      /**< Number of data records written */
+    uint8_t hasCount;           /**< 1 if the input has an S5/S6 record */
+    uint8_t countWritten;       /**< 1 once the S5/S6 record is written */
+} SrecReblock;
+
+/*******************************************************************************
+* Prototype
+*******************************************************************************/
+
+/**
+ * @brief: Encode a record and write it to the output file
+ *
+ * @param[inout] reblock: The re-blocking state.
+ * @param[in] decoded: The record to write.
+ */
+static void WriteRecord(SrecReblock* reblock, const SrecData* decoded)
+{
+    char line[LENGTH_OF_LINE];
+
+    EncodeSrecLine(decoded, line);
+    fputs(line, reblock->output);
+}
+
+/**
+ * @brief: Write the pending data record, if any
+ *
+ * @param[inout] reblock: The re-blocking state.
+ */
+static void FlushPending(SrecReblock* reblock)
+{
+    if (reblock->pending.lengthOfData > 0)
+    {
+        WriteRecord(reblock, &reblock->pending);
+        reblock->numberOfData++;
+        reblock->pending.lengthOfData = 0;
+    }
+}
+
+/**
+ * @brief: Write the S5/S6 count of the re-blocked data records, once
+ *
+ * @param[inout] reblock: The re-blocking state.
+ * @return: 1 if the count is written or not needed, 0 if it doesn't fit the 24-bit S6 field.
+ */
+static uint8_t WriteCount(SrecReblock* reblock)
+{
+    SrecData count;
+
+    if ((reblock->hasCount == 1) && (reblock->countWritten == 0))
+    {
+        reblock->countWritten = 1;
+
+        /* S5 holds a 16-bit count, S6 a 24-bit count */
+        if (reblock->numberOfData > 0xFFFFFF)
+        {
+            fprintf(stderr, "ERROR: %u data records don't fit the S6 count\n", reblock->numberOfData);
+            return 0;
+        }
+        count.type = (reblock->numberOfData > 0xFFFF) ? S6 : S5;
+        count.address = reblock->numberOfData;
+        count.lengthOfData = 0;
+        WriteRecord(reblock, &count);
+    }
+
+    return 1;
+}
+
+/**
+ * @brief: Append a data record to the pending record, writing full or non-contiguous records
+ *
+ * @param[inout] reblock: The re-blocking state.
+ * @param[in] decoded: The S1/S2/S3 record to append.
+ */
+static void AppendData(SrecReblock* reblock, const SrecData* decoded)
+{
+    SrecData* pending = &reblock->pending;
+    uint32_t maxLengthOfData;
+    uint32_t index;
+
+    /* Keep the record inside the 255 byte count limit */
+    maxLengthOfData = MAX_BYTE_COUNT - GetAddressLength(decoded->type) - 1;
+    if (reblock->maxLengthOfData < maxLengthOfData)
+    {
+        maxLengthOfData = reblock->maxLengthOfData;
+    }
+
+    /* Start a new record when the type changes or the address is not contiguous */
+    if ((pending->lengthOfData > 0) &&
+        ((pending->type != decoded->type) ||
+         ((uint64_t)decoded->address != ((uint64_t)pending->address + pending->lengthOfData))))
+    {
+        FlushPending(reblock);
+    }
+
+    for (index = 0; index < decoded->lengthOfData; index++)
+    {
+        if (pending->lengthOfData == 0)
+        {
+            pending->type = decoded->type;
+            pending->address = decoded->address + index;
+        }
+
+        pending->data[pending->lengthOfData++] = decoded->data[index];
+
+        if (pending->lengthOfData == maxLengthOfData)
+        {
+            FlushPending(reblock);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function
+*******************************************************************************/
+
+/**
+ * @brief: Re-block the data records of an S-record file
+ *
+ * @param[in] inputFile: The S-record file to re-block.
+ * @param[in] outputFile: The S-record file to write.
+ * @param[in] maxLengthOfData: The maximum number of data bytes per record.
+ * @return: 1 if the file was re-blocked, 0 otherwise.
+ */
+extern uint8_t ReblockSrec(const char* inputFile, const char* outputFile, uint32_t maxLengthOfData)
+{
+    char line[LENGTH_OF_LINE];
+    SrecReblock reblock;
+    SrecData decoded;
+    uint32_t numberOfLine;
+    uint8_t Flag;
+    FILE* srecfile;
+
+    if (maxLengthOfData == 0)
+    {
+        fprintf(stderr, "ERROR: Record length must be at least 1 byte\n");
+        return 0;
+    }
+
+    srecfile = fopen(inputFile, "r");
+    reblock.output = fopen(outputFile, "w");
+    if ((srecfile == NULL) || (reblock.output == NULL))
+    {
+        perror("ERROR: Can't open this file");
+        if (srecfile != NULL)
+        {
+            fclose(srecfile);
+        }
+        if (reblock.output != NULL)
+        {
+            fclose(reblock.output);
+        }
+        return 0;
+    }
+
+    Flag = 1;
+    numberOfLine = 0;
+    reblock.maxLengthOfData = maxLengthOfData;
+    reblock.pending.lengthOfData = 0;
+    reblock.numberOfData = 0;
+    reblock.hasCount = 0;
+    reblock.countWritten = 0;
+
+    while (fgets(line, sizeof(line), srecfile) != NULL)
+    {
+        numberOfLine++;
+
+        if (DecodeSrecLine(line, &decoded) != 1)
+        {
+            fprintf(stderr, "Line %u: invalid record\n", numberOfLine);
+            Flag = 0;
+            continue;
+        }
+        if (Flag != 1)
+        {
+            continue;  /* The output is removed, only report the other invalid lines */
+        }
+
+        switch (decoded.type)
+        {
+        case S1:
+        case S2:
+        case S3:
+            AppendData(&reblock, &decoded);
+            break;
+        case S5:
+        case S6:
+            /* The count is rewritten before the termination record */
+            reblock.hasCount = 1;
+            break;
+        case S7:
+        case S8:
+        case S9:
+            FlushPending(&reblock);
+            Flag = WriteCount(&reblock);
+            WriteRecord(&reblock, &decoded);
+            break;
+        default:
+            /* S0 header is copied with a fresh checksum */
+            FlushPending(&reblock);
+            WriteRecord(&reblock, &decoded);
+            break;
+        }
+    }
+
+    /* File without termination record */
+    if (Flag == 1)
+    {
+        FlushPending(&reblock);
+        Flag = WriteCount(&reblock);
+    }
+
+    fclose(srecfile);
+    fclose(reblock.output);
+
+    if (Flag != 1)
+    {
+        /* A file meant for flashing must not lose records or carry a wrong count */
+        fprintf(stderr, "ERROR: %s not re-blocked, nothing written\n", inputFile);
+        remove(outputFile);
+    }
+
+    return Flag;
+}
+
+/*******************************************************************************
+* EOF
+*******************************************************************************/
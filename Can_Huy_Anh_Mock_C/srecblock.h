@@ -0,0 +1,36 @@
+/*******************************************************************************
+* Include
+*******************************************************************************/
+
+#pragma once
+#ifndef SRECBLOCK_H
+#define SRECBLOCK_H
+#include "sreclib.h"
+
+/*******************************************************************************
+* API
+*******************************************************************************/
+
+/**
+ * @brief: To re-block the data records of an S-record file
+ *
+ * This function merges address-contiguous S1/S2/S3 records into records of up to maxLengthOfData bytes,
+ * recomputes every checksum and writes an S5/S6 count record matching the new number of data records when
+ * the input has one. The file is processed in one pass and only one pending record is kept in memory.
+ * Every invalid line is reported on stderr and the output file is then removed, so no record is lost.
+ * Records are never merged across the end of the address space.
+ *
+ * @param[in] inputFile: The S-record file to re-block.
+ * @param[in] outputFile: The S-record file to write.
+ * @param[in] maxLengthOfData: The maximum number of data bytes per record, limited by the 255 byte count.
+ * @param[out] None
+ * @param[inout] None
+ * @return: 1 if the file was re-blocked, 0 if a line is invalid or the count doesn't fit an S6 record.
+ */
+extern uint8_t ReblockSrec(const char* inputFile, const char* outputFile, uint32_t maxLengthOfData);
+
+#endif // !SRECBLOCK_H
+
+/*******************************************************************************
+* EOF
+*******************************************************************************/
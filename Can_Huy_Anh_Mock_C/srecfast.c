@@ -0,0 +1,209 @@
+/*******************************************************************************
+* Include
+*******************************************************************************/
+
+#include "srecfast.h"
+
+/*******************************************************************************
+* Prototype
+*******************************************************************************/
+
+/**
+ * @brief: Check the characters, byte count and checksum of a data line in one pass
+ *
+ * The result and its precedence match CheckHexaLine, CheckByteCountSrec then CheckSumSrec.
+ *
+ * @param[in] line: The data line, without newline.
+ * @param[in] lengthOfLine: The length of the line.
+ * @return: The error message, or NULL if the line is valid.
+ */
+static const char* CheckDataLine(const char* line, uint32_t lengthOfLine)
+{
+    uint32_t index;
+    uint8_t high;
+    uint8_t low;
+    uint8_t byteCount;
+    uint8_t sum;
+
+    sum = 0;
+    byteCount = 0;
+
+    /* Convert the pairs after the S-type, the S-type digit of a data line is always hexadecimal */
+    for (index = 2; (index + 1) < lengthOfLine; index += 2)
+    {
+        high = SrecHexValue[(uint8_t)line[index]];
+        low = SrecHexValue[(uint8_t)line[index + 1]];
+        if ((high | low) == 0xFF)
+        {
+            return "Invalid: The line has a non-hexadecimal character";
+        }
+        sum += (uint8_t)((high << 4) | low);
+        if (index == 2)
+        {
+            byteCount = (uint8_t)((high << 4) | low);
+        }
+    }
+
+    /* A line of odd length has one character left */
+    if ((index < lengthOfLine) && (SrecHexValue[(uint8_t)line[index]] == 0xFF))
+    {
+        return "Invalid: The line has a non-hexadecimal character";
+    }
+
+    if ((lengthOfLine < 4) || (byteCount < 3) || (((uint32_t)byteCount * 2) != (lengthOfLine - 4)))
+    {
+        return "Invalid: Wrong byte count";
+    }
+
+    /* Count, address, data and checksum add up to 0xFF */
+    if (sum != 0xFF)
+    {
+        return "Invalid: Checksum error";
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief: Check one line for a data record type known at compile time
+ *
+ * Called with constant typeOfData and lengthOfAddress from the specialized checkers, so the compiler folds
+ * the type compares and turns the address copy into a fixed-size copy.
+ *
+ * @param[inout] line: The line, the trailing newline is removed.
+ * @param[inout] record: The record holding the line number, receives the fields and the result.
+ * @param[in] typeOfData: The data record type of the file.
+ * @param[in] lengthOfAddress: The number of address characters of the type.
+ */
+static inline void CheckRecordWidth(char* line, SrecRecord* record, DataRecordType typeOfData, uint32_t lengthOfAddress)
+{
+    const char* errorMessage;
+    uint32_t lengthOfLine;
+    uint32_t lengthOfData;
+    SrecTpye stype;
+
+    errorMessage = NULL;
+    lengthOfLine = (uint32_t)strlen(line);
+
+    /* Remove trailing newline character if present. */
+    if ((lengthOfLine > 0) && (line[lengthOfLine - 1] == '\n'))
+    {
+        line[lengthOfLine - 1] = '\0';
+        lengthOfLine--;
+    }
+
+    stype = CheckSType(line);
+
+    /* Same precedence as CheckSrecRecord; only lines of the file's own type reach the field checks */
+    if (stype == INVALID)
+    {
+        errorMessage = "Invalid: Wrong S-type";
+    }
+    else if ((record->numberOfLine == 1) && (stype != S0))
+    {
+        errorMessage = "Invalid: First line is not S0 type.";
+    }
+    else if ((int)stype != (int)typeOfData)
+    {
+        if ((stype == S1) || (stype == S2) || (stype == S3))
+        {
+            errorMessage = "Invalid: Asynchronous S-type";
+        }
+    }
+    else
+    {
+        errorMessage = CheckDataLine(line, lengthOfLine);
+    }
+
+    record->errorMessage = (errorMessage != NULL) ? errorMessage : "Valid";
+
+    /* S5 lines always show 4 address characters */
+    if ((stype == S5) && (lengthOfAddress != 4))
+    {
+        lengthOfAddress = 4;
+    }
+
+    /* Extract address and data fields from the line. */
+    if (lengthOfLine >= (lengthOfAddress + 4 + 2))
+    {
+        memcpy(record->address, line + 4, lengthOfAddress);
+        record->address[lengthOfAddress] = '\0';
+        lengthOfData = lengthOfLine - lengthOfAddress - 4 - 2;
+        memcpy(record->data, line + 4 + lengthOfAddress, lengthOfData);
+    }
+    else
+    {
+        /* Short line, copy what is there like CheckSrecRecord */
+        strncpy(record->address, line + ((lengthOfLine < 4) ? lengthOfLine : 4), lengthOfAddress);
+        record->address[lengthOfAddress] = '\0';
+        lengthOfData = 0;
+    }
+    record->data[lengthOfData] = '\0';
+}
+
+/**
+ * @brief: Line checker for files of S1 records, 2 address bytes
+ *
+ * @param[inout] line: The line.
+ * @param[inout] record: The record.
+ */
+static void CheckSrecRecordS1(char* line, SrecRecord* record)
+{
+    CheckRecordWidth(line, record, S1_TYPE, 4);
+}
+
+/**
+ * @brief: Line checker for files of S2 records, 3 address bytes
+ *
+ * @param[inout] line: The line.
+ * @param[inout] record: The record.
+ */
+static void CheckSrecRecordS2(char* line, SrecRecord* record)
+{
+    CheckRecordWidth(line, record, S2_TYPE, 6);
+}
+
+/**
+ * @brief: Line checker for files of S3 records, 4 address bytes
+ *
+ * @param[inout] line: The line.
+ * @param[inout] record: The record.
+ */
+static void CheckSrecRecordS3(char* line, SrecRecord* record)
+{
+    CheckRecordWidth(line, record, S3_TYPE, 8);
+}
+
+/*******************************************************************************
+* Function
+*******************************************************************************/
+
+/**
+ * @brief: Select the line checker specialized for a data record type
+ *
+ * @param[in] typeOfData: The data record type of the file.
+ * @return: The specialized line checker.
+ */
+extern SrecRecordChecker GetSrecRecordChecker(DataRecordType typeOfData)
+{
+    SrecRecordChecker checker;
+
+    switch (typeOfData)
+    {
+    case S1_TYPE:
+        checker = CheckSrecRecordS1;
+        break;
+    case S2_TYPE:
+        checker = CheckSrecRecordS2;
+        break;
+    default:
+        checker = CheckSrecRecordS3;
+        break;
+    }
+
+    return checker;
+}
+
+/*******************************************************************************
+* EOF
+*******************************************************************************/
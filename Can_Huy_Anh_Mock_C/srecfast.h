@@ -0,0 +1,43 @@
+/*******************************************************************************
+* Include
+*******************************************************************************/
+
+#pragma once
+#ifndef SRECFAST_H
+#define SRECFAST_H
+#include "sreclib.h"
+
+/*******************************************************************************
+* Type
+*******************************************************************************/
+
+/**
+ * @brief: Line checker specialized for the data record type of a file
+ *
+ * A checker gives the same result as CheckSrecRecord(line, typeOfData, record) for the type it was selected for.
+ */
+typedef void (*SrecRecordChecker)(char* line, SrecRecord* record);
+
+/*******************************************************************************
+* API
+*******************************************************************************/
+
+/**
+ * @brief: To select the line checker specialized for a data record type
+ *
+ * Each checker is compiled for one address width (S1 = 2 bytes, S2 = 3, S3 = 4), so the address copy is a
+ * fixed-size copy and the S-type dispatch is reduced to a compare. Hex conversion, byte count and checksum are
+ * done in a single pass through a constant lookup table. Select once per file, then call for every line.
+ *
+ * @param[in] typeOfData: The data record type of the file.
+ * @param[out] None
+ * @param[inout] None
+ * @return: The specialized line checker.
+ */
+extern SrecRecordChecker GetSrecRecordChecker(DataRecordType typeOfData);
+
+#endif // !SRECFAST_H
+
+/*******************************************************************************
+* EOF
+*******************************************************************************/
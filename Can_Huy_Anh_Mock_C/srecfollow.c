@@ -0,0 +1,246 @@
+/*******************************************************************************
+* Include
+*******************************************************************************/
+
+#ifndef _WIN32
+/* POSIX declarations and 64-bit file offsets */
+#define _POSIX_C_SOURCE   200809L
+#define _FILE_OFFSET_BITS 64
+#endif
+#include "srecfollow.h"
+#include <threads.h>
+
+/* 64-bit seek so multi-GB files can be followed */
+#ifdef _WIN32
+#define SREC_FSEEK(file, offset) _fseeki64((file), (__int64)(offset), SEEK_SET)
+#else
+#define SREC_FSEEK(file, offset) fseeko((file), (off_t)(offset), SEEK_SET)
+#endif
+
+/*******************************************************************************
+* Prototype
+*******************************************************************************/
+
+/**
+ * @brief: Read one line and tell if it is complete
+ *
+ * @param[inout] srecfile: The S-record file.
+ * @param[out] line: The line read.
+ * @param[out] lengthOfLine: The number of bytes read.
+ * @return: 1 if a line ending with a newline was read, 0 if the file ends before the newline.
+ */
+static uint8_t ReadLine(FILE* srecfile, char* line, uint32_t* lengthOfLine)
+{
+    if (fgets(line, LENGTH_OF_LINE, srecfile) == NULL)
+    {
+        *lengthOfLine = 0;
+        return 0;
+    }
+
+    *lengthOfLine = (uint32_t)strlen(line);
+
+    /* A line longer than the buffer is split like the serial parser does */
+    return ((line[*lengthOfLine - 1] == '\n') || (*lengthOfLine == (LENGTH_OF_LINE - 1))) ? 1 : 0;
+}
+
+/**
+ * @brief: Find the data record type from the first data record after the saved offset
+ *
+ * @param[inout] follow: The follow state.
+ * @param[inout] srecfile: The S-record file.
+ * @param[in] final: 1 if the file won't grow anymore.
+ * @return: 1 if the type is known, 0 if no data record is complete yet.
+ */
+static uint8_t DetectTypeOfData(SrecFollow* follow, FILE* srecfile, uint8_t final)
+{
+    char line[LENGTH_OF_LINE];
+    uint32_t lengthOfLine;
+    SrecTpye stype;
+
+    SREC_FSEEK(srecfile, follow->offset);
+
+    while (ReadLine(srecfile, line, &lengthOfLine) == 1)
+    {
+        stype = CheckSType(line);
+        if ((stype == S1) || (stype == S2) || (stype == S3))
+        {
+            /* S1/S2/S3 and S1_TYPE/S2_TYPE/S3_TYPE share their values */
+            follow->typeOfData = (DataRecordType)stype;
+            follow->hasType = 1;
+            break;
+        }
+    }
+
+    /* A file without data record is checked as S1_TYPE, like CheckDataRecord does */
+    if ((follow->hasType == 0) && (final == 1))
+    {
+        follow->typeOfData = S1_TYPE;
+        follow->hasType = 1;
+    }
+
+    SREC_FSEEK(srecfile, follow->offset);
+
+    return follow->hasType;
+}
+
+/*******************************************************************************
+* Function
+*******************************************************************************/
+
+/**
+ * @brief: Initialize the state of a followed file
+ *
+ * @param[out] follow: The follow state.
+ */
+extern void InitSrecFollow(SrecFollow* follow)
+{
+    follow->offset = 0;
+    follow->numberOfLine = 0;
+    follow->numberOfData[0] = 0;
+    follow->numberOfData[1] = 0;
+    follow->numberOfData[2] = 0;
+    follow->typeOfData = S1_TYPE;
+    follow->hasType = 0;
+    follow->finished = 0;
+}
+
+/**
+ * @brief: Validate the complete lines appended since the last update
+ *
+ * @param[in] final: 1 if the file won't grow anymore, 0 otherwise.
+ * @param[inout] follow: The follow state.
+ * @param[inout] srecfile: The S-record file, opened in binary mode.
+ * @param[inout] output: The report file.
+ * @return: The number of lines validated.
+ */
+extern uint32_t UpdateSrecFollow(SrecFollow* follow, FILE* srecfile, FILE* output, uint8_t final)
+{
+    char line[LENGTH_OF_LINE];
+    SrecRecord record;
+    SrecTpye stype;
+    uint32_t lengthOfLine;
+    uint32_t numberOfNew;
+
+    numberOfNew = 0;
+
+    /* The address width of every line depends on the data record type */
+    if ((follow->hasType == 0) && (DetectTypeOfData(follow, srecfile, final) == 0))
+    {
+        return 0;
+    }
+
+    SREC_FSEEK(srecfile, follow->offset);
+
+    for (;;)
+    {
+        if ((ReadLine(srecfile, line, &lengthOfLine) == 0) && ((final == 0) || (lengthOfLine == 0)))
+        {
+            break;  /* Wait for the rest of the line */
+        }
+
+        follow->offset += lengthOfLine;
+        follow->numberOfLine++;
+        numberOfNew++;
+
+        /* The file is read in binary mode, drop the carriage return of CRLF lines */
+        if ((lengthOfLine >= 2) && (line[lengthOfLine - 2] == '\r') && (line[lengthOfLine - 1] == '\n'))
+        {
+            line[lengthOfLine - 2] = '\n';
+            line[lengthOfLine - 1] = '\0';
+        }
+
+        record.numberOfLine = follow->numberOfLine;
+        record.numberOfData = follow->numberOfData[0] + follow->numberOfData[1] + follow->numberOfData[2];
+
+        stype = CheckSType(line);
+        if ((stype == S1) || (stype == S2) || (stype == S3))
+        {
+            follow->numberOfData[stype - S1]++;
+        }
+
+        CheckSrecRecord(line, follow->typeOfData, &record);
+        PrintSrecRecord(output, &record);
+        PrintSrecRecord(stdout, &record);
+
+        if ((stype == S7) || (stype == S8) || (stype == S9))
+        {
+            follow->finished = 1;
+        }
+    }
+
+    fflush(output);
+
+    return numberOfNew;
+}
+
+/**
+ * @brief: Validate a growing S-record file until it is complete
+ *
+ * @param[in] inputFile: The S-record file.
+ * @param[in] outputFile: The report file.
+ * @param[in] idleSeconds: The time without growth after which following stops.
+ * @return: 1 if a termination record was reached, 0 otherwise.
+ */
+extern uint8_t FollowSrec(const char* inputFile, const char* outputFile, uint32_t idleSeconds)
+{
+    const struct timespec poll = { SREC_FOLLOW_POLL_MS / 1000, (SREC_FOLLOW_POLL_MS % 1000) * 1000000L };
+    SrecFollow follow;
+    uint32_t idleMilliseconds;
+    FILE* srecfile;
+    FILE* output;
+
+    srecfile = fopen(inputFile, "rb");
+    output = fopen(outputFile, "w");
+    if ((srecfile == NULL) || (output == NULL))
+    {
+        perror("ERROR: Can't open this file");
+        if (srecfile != NULL)
+        {
+            fclose(srecfile);
+        }
+        if (output != NULL)
+        {
+            fclose(output);
+        }
+        return 0;
+    }
+
+    InitSrecFollow(&follow);
+    idleMilliseconds = 0;
+
+    PrintSrecHeader(output);
+    PrintSrecHeader(stdout);
+
+    while (follow.finished == 0)
+    {
+        if (UpdateSrecFollow(&follow, srecfile, output, 0) > 0)
+        {
+            idleMilliseconds = 0;
+        }
+        else if (idleMilliseconds >= (idleSeconds * 1000))
+        {
+            /* No growth for too long, validate the last line even without newline */
+            UpdateSrecFollow(&follow, srecfile, output, 1);
+            break;
+        }
+        else
+        {
+            thrd_sleep(&poll, NULL);
+            idleMilliseconds += SREC_FOLLOW_POLL_MS;
+        }
+    }
+
+    if (follow.finished == 0)
+    {
+        fprintf(stderr, "ERROR: %s stopped growing before its termination record\n", inputFile);
+    }
+
+    fclose(srecfile);
+    fclose(output);
+
+    return follow.finished;
+}
+
+/*******************************************************************************
+* EOF
+*******************************************************************************/
@@ -0,0 +1,78 @@
+/*******************************************************************************
+* Include
+*******************************************************************************/
+
+#pragma once
+#ifndef SRECFOLLOW_H
+#define SRECFOLLOW_H
+#include "sreclib.h"
+
+#define SREC_FOLLOW_POLL_MS 200  /* Delay between two checks of the file size */
+
+/*******************************************************************************
+* Struct
+*******************************************************************************/
+
+/**
+ * @brief: Parser state saved at the last complete line of a growing S-record file
+ */
+typedef struct
+{
+    uint64_t offset;             /**< Byte offset after the last validated line */
+    uint32_t numberOfLine;       /**< Number of lines validated */
+    uint32_t numberOfData[3];    /**< Number of S1, S2 and S3 records validated */
+    DataRecordType typeOfData;   /**< Data record type, taken from the first data record */
+    uint8_t hasType;             /**< 1 once typeOfData is known */
+    uint8_t finished;            /**< 1 once a termination record is validated */
+} SrecFollow;
+
+/*******************************************************************************
+* API
+*******************************************************************************/
+
+/**
+ * @brief: To initialize the state of a followed file
+ *
+ * @param[in] None
+ * @param[out] follow: The follow state.
+ * @param[inout] None
+ * @return: None
+ */
+extern void InitSrecFollow(SrecFollow* follow);
+
+/**
+ * @brief: To validate the complete lines appended since the last update
+ *
+ * This function seeks to the saved offset and validates only the new complete lines, appending their results to
+ * the report. A line without newline is left for the next update unless final is 1. The data record type, and
+ * with it the address width, is fixed by the first data record of the file.
+ *
+ * @param[in] final: 1 if the file won't grow anymore, 0 otherwise.
+ * @param[out] None
+ * @param[inout] follow: The follow state.
+ * @param[inout] srecfile: The S-record file, opened in binary mode.
+ * @param[inout] output: The report file.
+ * @return: The number of lines validated.
+ */
+extern uint32_t UpdateSrecFollow(SrecFollow* follow, FILE* srecfile, FILE* output, uint8_t final);
+
+/**
+ * @brief: To validate a growing S-record file until it is complete
+ *
+ * This function validates the new tail of the file every SREC_FOLLOW_POLL_MS milliseconds until a termination
+ * record is validated or the file doesn't grow for idleSeconds.
+ *
+ * @param[in] inputFile: The S-record file.
+ * @param[in] outputFile: The report file.
+ * @param[in] idleSeconds: The time without growth after which following stops.
+ * @param[out] None
+ * @param[inout] None
+ * @return: 1 if a termination record was reached, 0 if the file stopped growing before it.
+ */
+extern uint8_t FollowSrec(const char* inputFile, const char* outputFile, uint32_t idleSeconds);
+
+#endif // !SRECFOLLOW_H
+
+/*******************************************************************************
+* EOF
+*******************************************************************************/
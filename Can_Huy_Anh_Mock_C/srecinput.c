@@ -0,0 +1,441 @@
+/*******************************************************************************
+* Include
+*******************************************************************************/
+
+#include "srecinput.h"
+#include <stdlib.h>
+#include <errno.h>
+#if (SREC_USE_ZLIB == 1)
+#include "srecring.h"
+#include <zlib.h>
+#endif
+
+/* First bytes of a gzip member */
+#define SREC_GZIP_MAGIC_0 0x1F
+#define SREC_GZIP_MAGIC_1 0x8B
+/* Marks that the reader holds no decompressed block */
+#define SREC_INPUT_NONE   UINT32_MAX
+
+/*******************************************************************************
+* Struct
+*******************************************************************************/
+
+/**
+ * @brief: An S-record input, plain text or gzip-compressed
+ */
+struct SrecInput
+{
+    FILE* file;                                            /**< Plain or compressed file */
+    uint8_t isGzip;                                        /**< 1 if the file is gzip-compressed */
+#if (SREC_USE_ZLIB == 1)
+    thrd_t thread;                                         /**< Decompression thread */
+    uint8_t running;                                       /**< 1 while the thread has to be joined */
+    atomic_int stop;                                       /**< Set by the reader to stop the thread early */
+    SrecRing freeRing;                                     /**< Reader -> decompressor: empty blocks */
+    SrecRing fullRing;                                     /**< Decompressor -> reader: decompressed blocks */
+    uint32_t lengthOfBlock[SREC_INPUT_BLOCKS];             /**< Number of bytes in each block */
+    uint32_t current;                                      /**< Block being read, SREC_INPUT_NONE if none */
+    uint32_t position;                                     /**< Read position in the current block */
+    uint8_t endOfStream;                                   /**< 1 once the decompressor is done */
+    uint8_t failed;                                        /**< 1 if the stream is corrupt or truncated, set before the end */
+    unsigned char compressed[SREC_INPUT_BLOCK];            /**< Compressed bytes, used by the decompressor */
+    char block[SREC_INPUT_BLOCKS][SREC_INPUT_BLOCK];       /**< Decompressed blocks */
+#endif
+};
+
+/*******************************************************************************
+* Prototype
+*******************************************************************************/
+
+#if (SREC_USE_ZLIB == 1)
+
+/**
+ * @brief: Decompression stage, inflate the file into the free blocks
+ *
+ * Concatenated gzip members are decompressed one after the other.
+ *
+ * @param[in] arg: The input.
+ * @return: 0
+ */
+static int DecompressStage(void* arg)
+{
+    SrecInput* input = (SrecInput*)arg;
+    z_stream stream;
+    uint32_t indexOfBlock;
+    uint32_t length;
+    uint8_t memberOpen;
+    uint8_t endOfFile;
+    uint8_t failed;
+    int status;
+
+    memset(&stream, 0, sizeof(stream));
+    failed = (inflateInit2(&stream, 15 + 16) == Z_OK) ? 0 : 1;  /* 15-bit window, gzip header */
+    memberOpen = 0;
+    endOfFile = 0;
+
+    while ((failed == 0) && (endOfFile == 0) && (atomic_load(&input->stop) == 0))
+    {
+        indexOfBlock = PopRing(&input->freeRing);
+        stream.next_out = (Bytef*)input->block[indexOfBlock];
+        stream.avail_out = SREC_INPUT_BLOCK;
+
+        while ((stream.avail_out > 0) && (failed == 0))
+        {
+            if (stream.avail_in == 0)
+            {
+                length = (uint32_t)fread(input->compressed, 1, sizeof(input->compressed), input->file);
+                if (length == 0)
+                {
+                    endOfFile = 1;
+                    failed = memberOpen;  /* The last member is truncated */
+                    break;
+                }
+                stream.next_in = input->compressed;
+                stream.avail_in = length;
+            }
+
+            memberOpen = 1;
+            status = inflate(&stream, Z_NO_FLUSH);
+            if (status == Z_STREAM_END)
+            {
+                /* Another member may follow */
+                memberOpen = 0;
+                inflateReset(&stream);
+            }
+            else if ((status != Z_OK) && (status != Z_BUF_ERROR))
+            {
+                failed = 1;
+            }
+        }
+
+        length = SREC_INPUT_BLOCK - stream.avail_out;
+        if (length > 0)
+        {
+            input->lengthOfBlock[indexOfBlock] = length;
+            PushRing(&input->fullRing, indexOfBlock);
+        }
+    }
+
+    /* Published to the reader by the end marker */
+    input->failed = failed;
+
+    inflateEnd(&stream);
+    PushRing(&input->fullRing, SREC_RING_END);
+
+    return 0;
+}
+
+/**
+ * @brief: Start decompressing from the beginning of the file
+ *
+ * @param[inout] input: The input, with its thread stopped.
+ * @return: 1 if the thread is started, 0 otherwise.
+ */
+static uint8_t StartDecompress(SrecInput* input)
+{
+    uint32_t index;
+
+    atomic_init(&input->freeRing.head, 0);
+    atomic_init(&input->freeRing.tail, 0);
+    atomic_init(&input->fullRing.head, 0);
+    atomic_init(&input->fullRing.tail, 0);
+    atomic_init(&input->stop, 0);
+    input->current = SREC_INPUT_NONE;
+    input->position = 0;
+    input->endOfStream = 0;
+    input->failed = 0;
+
+    for (index = 0; index < SREC_INPUT_BLOCKS; index++)
+    {
+        PushRing(&input->freeRing, index);
+    }
+
+    input->running = (thrd_create(&input->thread, DecompressStage, input) == thrd_success) ? 1 : 0;
+    if (input->running == 0)
+    {
+        /* Nothing will fill the ring, the input reads as empty and failed */
+        input->endOfStream = 1;
+        input->failed = 1;
+    }
+
+    return input->running;
+}
+
+/**
+ * @brief: Stop the decompression thread, draining the blocks it still produces
+ *
+ * @param[inout] input: The input.
+ */
+static void StopDecompress(SrecInput* input)
+{
+    uint32_t indexOfBlock;
+
+    if (input->running == 1)
+    {
+        atomic_store(&input->stop, 1);
+
+        /* Give back every block so the thread is never stuck on a full ring */
+        if (input->current != SREC_INPUT_NONE)
+        {
+            PushRing(&input->freeRing, input->current);
+            input->current = SREC_INPUT_NONE;
+        }
+        while (input->endOfStream == 0)
+        {
+            indexOfBlock = PopRing(&input->fullRing);
+            if (indexOfBlock == SREC_RING_END)
+            {
+                input->endOfStream = 1;
+            }
+            else
+            {
+                PushRing(&input->freeRing, indexOfBlock);
+            }
+        }
+
+        thrd_join(input->thread, NULL);
+        input->running = 0;
+    }
+}
+
+#endif
+
+/*******************************************************************************
+* Function
+*******************************************************************************/
+
+/**
+ * @brief: Open an S-record input, detecting gzip by its magic bytes
+ *
+ * @param[in] fileName: The S-record file, plain or gzip-compressed.
+ * @return: The input, or NULL if it can't be opened.
+ */
+extern SrecInput* OpenSrecInput(const char* fileName)
+{
+    unsigned char magic[2];
+    SrecInput* input;
+    FILE* file;
+
+    file = fopen(fileName, "rb");
+    if (file == NULL)
+    {
+        return NULL;
+    }
+
+    if ((fread(magic, 1, sizeof(magic), file) != sizeof(magic)) ||
+        (magic[0] != SREC_GZIP_MAGIC_0) || (magic[1] != SREC_GZIP_MAGIC_1))
+    {
+        /* Plain text, reopen in text mode */
+        fclose(file);
+        file = fopen(fileName, "r");
+        if (file == NULL)
+        {
+            return NULL;
+        }
+        input = (SrecInput*)malloc(sizeof(SrecInput));
+        if (input == NULL)
+        {
+            fclose(file);
+            return NULL;
+        }
+        input->file = file;
+        input->isGzip = 0;
+#if (SREC_USE_ZLIB == 1)
+        input->running = 0;
+#endif
+        return input;
+    }
+
+#if (SREC_USE_ZLIB == 1)
+    rewind(file);
+    input = (SrecInput*)malloc(sizeof(SrecInput));
+    if (input == NULL)
+    {
+        fclose(file);
+        return NULL;
+    }
+    input->file = file;
+    input->isGzip = 1;
+    if (StartDecompress(input) != 1)
+    {
+        fclose(file);
+        free(input);
+        return NULL;
+    }
+    return input;
+#else
+    fprintf(stderr, "ERROR: %s is gzip-compressed, build with SREC_USE_ZLIB=1 to read it\n", fileName);
+    fclose(file);
+    errno = EINVAL;
+    return NULL;
+#endif
+}
+
+/**
+ * @brief: Read one line of an S-record input, like fgets
+ *
+ * @param[in] size: The size of the line buffer.
+ * @param[out] line: The line read.
+ * @param[inout] input: The input.
+ * @return: line, or NULL at the end of the input.
+ */
+extern char* GetsSrecInput(char* line, uint32_t size, SrecInput* input)
+{
+#if (SREC_USE_ZLIB == 1)
+    const char* start;
+    const char* newline;
+    uint32_t lengthOfLine;
+    uint32_t length;
+
+    if (input->isGzip == 0)
+    {
+        return fgets(line, (int)size, input->file);
+    }
+
+    lengthOfLine = 0;
+    while ((lengthOfLine + 1) < size)
+    {
+        if (input->current == SREC_INPUT_NONE)
+        {
+            if (input->endOfStream == 1)
+            {
+                break;
+            }
+            input->current = PopRing(&input->fullRing);
+            input->position = 0;
+            if (input->current == SREC_RING_END)
+            {
+                input->current = SREC_INPUT_NONE;
+                input->endOfStream = 1;
+                break;
+            }
+        }
+
+        /* Copy up to the newline, the end of the block or the end of the buffer */
+        start = &input->block[input->current][input->position];
+        length = input->lengthOfBlock[input->current] - input->position;
+        if (length > (size - 1 - lengthOfLine))
+        {
+            length = size - 1 - lengthOfLine;
+        }
+        newline = (const char*)memchr(start, '\n', length);
+        if (newline != NULL)
+        {
+            length = (uint32_t)(newline - start) + 1;
+        }
+
+        memcpy(&line[lengthOfLine], start, length);
+        lengthOfLine += length;
+        input->position += length;
+
+        if (input->position == input->lengthOfBlock[input->current])
+        {
+            PushRing(&input->freeRing, input->current);
+            input->current = SREC_INPUT_NONE;
+        }
+        if (newline != NULL)
+        {
+            break;
+        }
+    }
+
+    if (lengthOfLine == 0)
+    {
+        return NULL;
+    }
+
+    line[lengthOfLine] = '\0';
+    return line;
+#else
+    return fgets(line, (int)size, input->file);
+#endif
+}
+
+/**
+ * @brief: Restart an S-record input from its beginning
+ *
+ * @param[inout] input: The input.
+ * @return: 1 if the input is restarted, 0 otherwise.
+ */
+extern uint8_t RewindSrecInput(SrecInput* input)
+{
+#if (SREC_USE_ZLIB == 1)
+    if (input->isGzip == 1)
+    {
+        StopDecompress(input);
+        rewind(input->file);
+        return StartDecompress(input);
+    }
+#endif
+
+    rewind(input->file);
+
+    return 1;
+}
+
+/**
+ * @brief: Check that an S-record input was read completely
+ *
+ * @param[in] input: The input, read until GetsSrecInput returned NULL.
+ * @return: 1 if the whole input was read, 0 on a read error or a corrupt or truncated gzip stream.
+ */
+extern uint8_t CheckSrecInput(const SrecInput* input)
+{
+#if (SREC_USE_ZLIB == 1)
+    if (input->isGzip == 1)
+    {
+        return (input->failed == 0) ? 1 : 0;
+    }
+#endif
+
+    return (ferror(input->file) == 0) ? 1 : 0;
+}
+
+/**
+ * @brief: Determine the predominant data record type of an S-record input
+ *
+ * @param[inout] input: The input.
+ * @return: The most frequent data record type.
+ */
+extern DataRecordType CheckDataRecordInput(SrecInput* input)
+{
+    char line[LENGTH_OF_LINE];
+    uint32_t numberOfType[3];
+    SrecTpye typeOfLine;
+
+    numberOfType[0] = 0;
+    numberOfType[1] = 0;
+    numberOfType[2] = 0;
+
+    while (GetsSrecInput(line, sizeof(line), input) != NULL)
+    {
+        typeOfLine = CheckSType(line);
+        if ((typeOfLine == S1) || (typeOfLine == S2) || (typeOfLine == S3))
+        {
+            numberOfType[typeOfLine - S1]++;
+        }
+    }
+
+    return SelectDataRecord(numberOfType[0], numberOfType[1], numberOfType[2]);
+}
+
+/**
+ * @brief: Close an S-record input
+ *
+ * @param[inout] input: The input.
+ */
+extern void CloseSrecInput(SrecInput* input)
+{
+    if (input != NULL)
+    {
+#if (SREC_USE_ZLIB == 1)
+        StopDecompress(input);
+#endif
+        fclose(input->file);
+        free(input);
+    }
+}
+
+/*******************************************************************************
+* EOF
+*******************************************************************************/
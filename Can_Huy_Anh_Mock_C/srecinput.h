@@ -0,0 +1,105 @@
+/*******************************************************************************
+* Include
+*******************************************************************************/
+
+#pragma once
+#ifndef SRECINPUT_H
+#define SRECINPUT_H
+#include "sreclib.h"
+
+/* 1 to read gzip-compressed S-record files with zlib, set by the project from its SrecUseZlib property */
+#ifndef SREC_USE_ZLIB
+#define SREC_USE_ZLIB 0
+#endif
+
+#define SREC_INPUT_BLOCK  65536  /* Size of a decompressed block */
+#define SREC_INPUT_BLOCKS 4      /* Number of decompressed blocks in flight */
+
+/*******************************************************************************
+* Struct
+*******************************************************************************/
+
+/**
+ * @brief: An S-record input, plain text or gzip-compressed
+ */
+typedef struct SrecInput SrecInput;
+
+/*******************************************************************************
+* API
+*******************************************************************************/
+
+/**
+ * @brief: To open an S-record input, detecting gzip by its magic bytes
+ *
+ * A plain file is read directly. A gzip file is decompressed on a separate thread into SREC_INPUT_BLOCKS
+ * blocks of SREC_INPUT_BLOCK bytes handed to the reader through lock-free ring buffers, so decompression
+ * overlaps validation with bounded memory and no temporary file.
+ *
+ * @param[in] fileName: The S-record file, plain or gzip-compressed.
+ * @param[out] None
+ * @param[inout] None
+ * @return: The input, or NULL if it can't be opened.
+ */
+extern SrecInput* OpenSrecInput(const char* fileName);
+
+/**
+ * @brief: To read one line of an S-record input, like fgets
+ *
+ * @param[in] size: The size of the line buffer.
+ * @param[out] line: The line read, with its newline if it fits.
+ * @param[inout] input: The input.
+ * @return: line, or NULL at the end of the input.
+ */
+extern char* GetsSrecInput(char* line, uint32_t size, SrecInput* input);
+
+/**
+ * @brief: To restart an S-record input from its beginning
+ *
+ * A gzip input is decompressed again from the start.
+ *
+ * @param[in] None
+ * @param[out] None
+ * @param[inout] input: The input.
+ * @return: 1 if the input is restarted, 0 otherwise, the input then reads as empty.
+ */
+extern uint8_t RewindSrecInput(SrecInput* input);
+
+/**
+ * @brief: To check that an S-record input was read completely
+ *
+ * A corrupt or truncated gzip stream ends the input early, GetsSrecInput returns NULL as at a normal end.
+ *
+ * @param[in] input: The input, read until GetsSrecInput returned NULL.
+ * @param[out] None
+ * @param[inout] None
+ * @return: 1 if the whole input was read, 0 on a read error or a corrupt or truncated gzip stream.
+ */
+extern uint8_t CheckSrecInput(const SrecInput* input);
+
+/**
+ * @brief: To determine the predominant data record type of an S-record input
+ *
+ * Same as CheckDataRecord, reading from the current position to the end of the input.
+ *
+ * @param[in] None
+ * @param[out] None
+ * @param[inout] input: The input.
+ * @return: The most frequent data record type.
+ */
+extern DataRecordType CheckDataRecordInput(SrecInput* input);
+
+/**
+ * @brief: To close an S-record input
+ *
+ * @param[in] None
+ * @param[out] None
+ * @param[inout] input: The input.
+ * @return: None
+ */
+extern void CloseSrecInput(SrecInput* input);
+
+#endif // !SRECINPUT_H
+
+/*******************************************************************************
+* EOF
+*******************************************************************************/
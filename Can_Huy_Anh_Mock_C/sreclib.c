@@ -6,6 +6,27 @@
 /* Define max function to find the maximum of 2 numbers */
 #define MAX(x, y) (x > y ? x : y)
 
+/* Value of each character as a hexadecimal digit, 0xFF (WORTHLESS) if it is not one */
+const uint8_t SrecHexValue[256] =
+{
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
 /*******************************************************************************
 * Prototype
 *******************************************************************************/
@@ -20,60 +41,7 @@
  */
 static uint8_t ConvertHexToIntDigit(char hexadecimal)
 {
-    uint8_t newvalue;
-
-    /* Check if the character is between '0' and '9' */
-    if ((hexadecimal >= '0') && (hexadecimal <= '9'))
-    {
-        newvalue = hexadecimal - '0';  /* Convert '0'-'9' to 0-9 */
-    }
-    /* Check if the character is between 'A' and 'F' */
-    else if ((hexadecimal >= 'A') && (hexadecimal <= 'F'))
-    {
-        newvalue = hexadecimal - 'A' + 10;  /* Convert 'A'-'F' to 10-15 */
-    }
-    /* Check if the character is between 'a' and 'f' */
-    else if ((hexadecimal >= 'a') && (hexadecimal <= 'f'))
-    {
-        newvalue = hexadecimal - 'a' + 10;  /* Convert 'a'-'f' to 10-15 */
-    }
-    else
-    {
-        newvalue = WORTHLESS;  /* Return WORTHLESS if character is not valid */
-    }
-
-    return newvalue;
-}
-
-/**
- * @brief: Convert a pair of hexadecimal characters to their integer value
- *
- * This function converts a pair of hexadecimal characters to a single integer value.
- *
- * @param[in] hexadecimal: The pair of hexadecimal characters to convert.
- * @return: The integer value of the hexadecimal pair, or WORTHLESS if invalid.
- */
-static uint8_t ConvertHextoInt(const char* hexadecimal)
-{
-    uint8_t HighDigit;
-    uint8_t LowDigit;
-    uint8_t newValue;
-
-    /* Convert the high and low hexadecimal digits to integer values */
-    HighDigit = ConvertHexToIntDigit(hexadecimal[0]);
-    LowDigit = ConvertHexToIntDigit(hexadecimal[1]);
-
-    /* Combine the high and low digits to form the integer value */
-    if ((HighDigit != WORTHLESS) && (LowDigit != WORTHLESS))
-    {
-        newValue = (HighDigit << 4) + LowDigit;  /* Shift high digit and add low digit */
-    }
-    else
-    {
-        newValue = WORTHLESS;  /* Return WORTHLESS if any digit is invalid */
-    }
-
-    return newValue;
+    return SrecHexValue[(uint8_t)hexadecimal];
 }
 
 /**
@@ -227,7 +195,7 @@ extern uint8_t CheckByteCountSrec(const char* line, uint32_t lengthOfLine)
     else
     {
         /* Convert byte count from hexadecimal to integer */
-        ByteCount = ConvertHextoInt(&line[2]);
+        ByteCount = ReadSrecHexByte(&line[2]);
 
         /* Check if the byte count is valid */
         if (ByteCount == WORTHLESS)
@@ -264,7 +232,7 @@ extern uint8_t CheckSumSrec(const char* line)
     uint8_t Flag;
     uint8_t sum;
     uint32_t lengthOfLine;
-    uint8_t index;
+    uint32_t index;
     uint8_t convertedValue;
     uint8_t LineCheckSum;
     uint8_t ComputedCheckSum;
@@ -285,7 +253,7 @@ extern uint8_t CheckSumSrec(const char* line)
     /* Calculate the checksum */
     for (index = 2; index < lengthOfLine - 2; index += 2)
     {
-        convertedValue = ConvertHextoInt(&line[index]);
+        convertedValue = ReadSrecHexByte(&line[index]);
         if (convertedValue == WORTHLESS)
         {
             Flag = 0;  /* Conversion error */
@@ -297,7 +265,7 @@ extern uint8_t CheckSumSrec(const char* line)
     }
 
     /* Get the checksum value from the line */
-    LineCheckSum = ConvertHextoInt(&line[lengthOfLine - 2]);
+    LineCheckSum = ReadSrecHexByte(&line[lengthOfLine - 2]);
 
     /* Check if the checksum value is valid */
     if (LineCheckSum == WORTHLESS)
@@ -337,14 +305,8 @@ extern uint8_t CheckLineCount(FILE* srecfile)
     SrecTpye typeOfLine;
     uint8_t Flag;
     uint32_t numberOfLineData;
-    uint32_t firstDigit;
-    uint32_t secondDigit;
-    uint32_t thirdDigit;
-    uint32_t fouthDigit;
-    uint32_t fifthDigit;
-    uint32_t sixthDigit;
-    uint32_t lineCount;
 
+    Flag = 1;
     numberOfLineData = 0;
 
     /* Read lines from the file */
@@ -356,44 +318,10 @@ extern uint8_t CheckLineCount(FILE* srecfile)
         {
             numberOfLineData++;  /* Increment data line count */
         }
-        else if (typeOfLine == S5)
+        else if ((typeOfLine == S5) || (typeOfLine == S6))
         {
-            /* Extract and compute the line count from the S5 record */
-            firstDigit = ConvertHexToIntDigit(line[4]);
-            secondDigit = ConvertHexToIntDigit(line[5]);
-            thirdDigit = ConvertHexToIntDigit(line[6]);
-            fouthDigit = ConvertHexToIntDigit(line[7]);
-
-            lineCount = ((firstDigit << 12) + (secondDigit << 8) + (thirdDigit << 4) + fouthDigit);
-            if (lineCount == numberOfLineData)
-            {
-                Flag = 1;  /* Line count matches */
-            }
-            else
-            {
-                Flag = 0;  /* Line count mismatch */
-            }
-        }
-        else if (typeOfLine == S6)
-        {
-            /* Extract and compute the line count from the S6 record */
-            firstDigit = ConvertHexToIntDigit(line[4]);
-            secondDigit = ConvertHexToIntDigit(line[5]);
-            thirdDigit = ConvertHexToIntDigit(line[6]);
-            fouthDigit = ConvertHexToIntDigit(line[7]);
-            fifthDigit = ConvertHexToIntDigit(line[8]);
-            sixthDigit = ConvertHexToIntDigit(line[9]);
-
-            lineCount = ((firstDigit << 20) + (secondDigit << 16) + (thirdDigit << 12)
-                + (fouthDigit << 8) + (fifthDigit << 4) + sixthDigit);
-            if (lineCount == numberOfLineData)
-            {
-                Flag = 1;  /* Line count matches */
-            }
-            else
-            {
-                Flag = 0;  /* Line count mismatch */
-            }
+            /* Compare the count stored in the S5/S6 record */
+            Flag = CheckLineCountSrec(line, numberOfLineData);
         }
         else
         {
@@ -414,13 +342,11 @@ extern uint8_t CheckLineCount(FILE* srecfile)
  */
 extern DataRecordType CheckDataRecord(FILE* srecfile)
 {
-    DataRecordType recordType;
     uint32_t numberOfS1;
     uint32_t numberOfS2;
     uint32_t numberOfS3;
     SrecTpye typeOfLine;
     char line[LENGTH_OF_LINE];
-    uint32_t maxOfThree;
 
     numberOfS1 = 0;
     numberOfS2 = 0;
@@ -449,6 +375,22 @@ extern DataRecordType CheckDataRecord(FILE* srecfile)
         }
     }
 
+    return SelectDataRecord(numberOfS1, numberOfS2, numberOfS3);
+}
+
+/**
+ * @brief: Select the predominant data record type from the record counts
+ *
+ * @param[in] numberOfS1: The number of S1 records.
+ * @param[in] numberOfS2: The number of S2 records.
+ * @param[in] numberOfS3: The number of S3 records.
+ * @return: The most frequent data record type.
+ */
+extern DataRecordType SelectDataRecord(uint32_t numberOfS1, uint32_t numberOfS2, uint32_t numberOfS3)
+{
+    DataRecordType recordType;
+    uint32_t maxOfThree;
+
     /* Determine the maximum count among S1, S2, and S3 records */
     maxOfThree = MAX(numberOfS1, MAX(numberOfS2, numberOfS3));
     if (maxOfThree == numberOfS1)
@@ -550,6 +492,467 @@ extern uint8_t CheckHexaLine(const char* line, uint32_t lengthOfLine)
     return Flag;
 }
 
+/**
+ * @brief: Check the count field of an S5/S6 line
+ *
+ * This function compares the 16-bit (S5) or 24-bit (S6) count with the number of data records before the line.
+ *
+ * @param[in] line: The S5 or S6 line.
+ * @param[in] numberOfLineData: The number of S1/S2/S3 records before the line.
+ * @return: 1 if the line count is correct, 0 otherwise.
+ */
+extern uint8_t CheckLineCountSrec(const char* line, uint32_t numberOfLineData)
+{
+    SrecTpye typeOfLine;
+    uint8_t Flag;
+    uint32_t numberOfDigit;
+    uint32_t lineCount;
+    uint32_t index;
+    uint8_t digit;
+
+    Flag = 1;
+    lineCount = 0;
+    typeOfLine = CheckSType(line);
+
+    /* S5 stores the count in 4 digits, S6 in 6 digits */
+    if (typeOfLine == S5)
+    {
+        numberOfDigit = 4;
+    }
+    else if (typeOfLine == S6)
+    {
+        numberOfDigit = 6;
+    }
+    else
+    {
+        numberOfDigit = 0;
+        Flag = 0;  /* Not a count record */
+    }
+
+    if ((Flag == 1) && (strlen(line) < (4 + numberOfDigit)))
+    {
+        Flag = 0;  /* Line too short to hold the count */
+    }
+
+    /* Extract and compute the line count from the record */
+    for (index = 0; (Flag == 1) && (index < numberOfDigit); index++)
+    {
+        digit = ConvertHexToIntDigit(line[4 + index]);
+        if (digit == (uint8_t)WORTHLESS)
+        {
+            Flag = 0;  /* Invalid digit */
+        }
+        else
+        {
+            lineCount = (lineCount << 4) + digit;
+        }
+    }
+
+    if ((Flag == 1) && (lineCount != numberOfLineData))
+    {
+        Flag = 0;  /* Line count mismatch */
+    }
+
+    return Flag;
+}
+
+/**
+ * @brief: Get the length of the address field shown in the parsing report
+ *
+ * @param[in] stype: The S-type of the line.
+ * @param[in] typeOfData: The data record type of the file.
+ * @return: The number of address characters (4, 6 or 8).
+ */
+extern uint32_t GetLengthOfAddress(SrecTpye stype, DataRecordType typeOfData)
+{
+    uint32_t lengthOfAddress;
+
+    /* Determine the length of the address field based on the S-record type. */
+    if (typeOfData == S1_TYPE || stype == S5)
+    {
+        lengthOfAddress = 4;
+    }
+    else if (typeOfData == S2_TYPE)
+    {
+        lengthOfAddress = 6;
+    }
+    else
+    {
+        lengthOfAddress = 8;
+    }
+
+    return lengthOfAddress;
+}
+
+/**
+ * @brief: Check if a data line falls in an address window
+ *
+ * This function converts only the byte count and address fields of the line.
+ *
+ * @param[in] line: The line from the S-record file.
+ * @param[in] lengthOfAddress: The number of address characters.
+ * @param[in] firstAddress: The first address of the window.
+ * @param[in] lastAddress: The last address of the window.
+ * @return: 1 if the data overlaps the window or the fields can't be converted, 0 otherwise.
+ */
+extern uint8_t CheckSrecWindow(const char* line, uint32_t lengthOfAddress, uint32_t firstAddress, uint32_t lastAddress)
+{
+    uint32_t address;
+    uint32_t byteCount;
+    uint32_t lengthOfData;
+    uint32_t index;
+    uint8_t digit;
+
+    address = 0;
+    byteCount = 0;
+
+    /* Byte count and address are contiguous, a NUL or newline stops the conversion */
+    for (index = 2; index < (4 + lengthOfAddress); index++)
+    {
+        digit = ConvertHexToIntDigit(line[index]);
+        if (digit == (uint8_t)WORTHLESS)
+        {
+            return 1;  /* Let the full validation report the line */
+        }
+
+        if (index < 4)
+        {
+            byteCount = (byteCount << 4) + digit;
+        }
+        else
+        {
+            address = (address << 4) + digit;
+        }
+    }
+
+    /* Data bytes follow the address and precede the checksum */
+    if (byteCount > ((lengthOfAddress / 2) + 1))
+    {
+        lengthOfData = byteCount - (lengthOfAddress / 2) - 1;
+    }
+    else
+    {
+        lengthOfData = 1;  /* Check the address alone */
+    }
+
+    return ((address <= lastAddress) && (((uint64_t)address + lengthOfData - 1) >= firstAddress)) ? 1 : 0;
+}
+
+/**
+ * @brief: Validate one line of the S-record file and extract its fields
+ *
+ * This function applies the line checks in order and keeps the first error, then splits the line into address and data.
+ *
+ * @param[in] typeOfData: The data record type of the file.
+ * @param[inout] line: The line from the S-record file, the trailing newline is removed.
+ * @param[inout] record: The record holding the line number and data count, receives the fields and the result.
+ */
+extern void CheckSrecRecord(char* line, DataRecordType typeOfData, SrecRecord* record)
+{
+    SrecTpye stype;
+    uint32_t lengthOfLine;
+    uint32_t lengthOfAddress;
+    uint32_t lengthOfData;
+
+    record->errorMessage = "Valid";  /* Initialize error message as "Valid". */
+    lengthOfLine = (uint32_t)strlen(line);
+
+    /* Remove trailing newline character if present. */
+    if ((lengthOfLine > 0) && (line[lengthOfLine - 1] == '\n'))
+    {
+        line[lengthOfLine - 1] = '\0';
+        lengthOfLine--;
+    }
+
+    stype = CheckSType(line);  /* Determine the type of S-record. */
+
+    /* Determine the length of the address field based on the S-record type. */
+    lengthOfAddress = GetLengthOfAddress(stype, typeOfData);
+
+    /* Check for various validation errors. */
+    if (stype == INVALID)
+    {
+        record->errorMessage = "Invalid: Wrong S-type";
+    }
+    else if ((record->numberOfLine == 1) && (CheckSrecStart(line) != 1))
+    {
+        record->errorMessage = "Invalid: First line is not S0 type.";
+    }
+    else if ((stype != typeOfData))
+    {
+        if (stype == S0 || stype == S9 || stype == S5 || stype == S8 || stype == S7 || stype == S6)
+        {
+            /* No specific action for these S-types in this condition. */
+        }
+        else
+        {
+            record->errorMessage = "Invalid: Asynchronous S-type";
+        }
+    }
+    else if (CheckHexaLine(line, lengthOfLine) != 1)
+    {
+        record->errorMessage = "Invalid: The line has a non-hexadecimal character";
+    }
+    else if (CheckByteCountSrec(line, lengthOfLine) != 1)
+    {
+        record->errorMessage = "Invalid: Wrong byte count";
+    }
+    else if (CheckSumSrec(line) != 1)
+    {
+        record->errorMessage = "Invalid: Checksum error";
+    }
+    else if (((stype == S5) || (stype == S6)) && (CheckLineCountSrec(line, record->numberOfData) != 1))
+    {
+        record->errorMessage = "Invalid: Linecount error";
+    }
+    else if (((stype == S9) || (stype == S8) || (stype == S7)) && (CheckSrecTerminate(line, typeOfData) != 1))
+    {
+        record->errorMessage = "Invalid: Terminate error";
+    }
+
+    /* Extract address and data fields from the line. */
+    strncpy(record->address, line + ((lengthOfLine < 4) ? lengthOfLine : 4), lengthOfAddress);
+    record->address[lengthOfAddress] = '\0';
+    if (lengthOfLine >= (lengthOfAddress + 4 + 2))
+    {
+        lengthOfData = lengthOfLine - lengthOfAddress - 4 - 2;
+        strncpy(record->data, line + 4 + lengthOfAddress, lengthOfData);
+    }
+    else
+    {
+        lengthOfData = 0;  /* Line too short to hold any data */
+    }
+    record->data[lengthOfData] = '\0';
+}
+
+/**
+ * @brief: Print the header of the parsing report
+ *
+ * @param[inout] output: The stream that receives the header.
+ */
+extern void PrintSrecHeader(FILE* output)
+{
+    fprintf(output, "%-10s %-10s %-70s %-8s\n", "LINE", "ADDRESS", "DATA", "ERROR MESSAGE");
+}
+
+/**
+ * @brief: Print one parsed record of the parsing report
+ *
+ * @param[in] record: The parsed record.
+ * @param[inout] output: The stream that receives the record.
+ */
+extern void PrintSrecRecord(FILE* output, const SrecRecord* record)
+{
+    fprintf(output, "%-10u %-10s %-70s %-20s\n", record->numberOfLine, record->address, record->data, record->errorMessage);
+}
+
+/**
+ * @brief: Get the length of the address field of an S-type
+ *
+ * @param[in] type: The S-type of the line.
+ * @return: The number of address bytes (2, 3 or 4), 0 if the S-type is invalid.
+ */
+extern uint32_t GetAddressLength(SrecTpye type)
+{
+    uint32_t lengthOfAddress;
+
+    switch (type)
+    {
+    case S0:
+    case S1:
+    case S5:
+    case S9:
+        lengthOfAddress = 2;
+        break;
+    case S2:
+    case S6:
+    case S8:
+        lengthOfAddress = 3;
+        break;
+    case S3:
+    case S7:
+        lengthOfAddress = 4;
+        break;
+    default:
+        lengthOfAddress = 0;  /* Invalid S-type */
+        break;
+    }
+
+    return lengthOfAddress;
+}
+
+/**
+ * @brief: Decode the fields of an S-record line
+ *
+ * This function validates the line and converts its address and data fields to binary.
+ *
+ * @param[in] line: The line from the S-record file, a trailing newline is allowed.
+ * @param[out] decoded: The decoded fields of the line.
+ * @return: 1 if the line is a valid record, 0 otherwise.
+ */
+extern uint8_t DecodeSrecLine(const char* line, SrecData* decoded)
+{
+    uint8_t Flag;
+    uint32_t lengthOfLine;
+    uint32_t lengthOfAddress;
+    uint32_t byteCount;
+    uint32_t index;
+    uint8_t sum;
+    uint8_t value;
+
+    Flag = 1;
+    lengthOfLine = (uint32_t)strlen(line);
+
+    /* Ignore the line ending */
+    while ((lengthOfLine > 0) && ((line[lengthOfLine - 1] == '\n') || (line[lengthOfLine - 1] == '\r')))
+    {
+        lengthOfLine--;
+    }
+
+    decoded->type = CheckSType(line);
+    lengthOfAddress = GetAddressLength(decoded->type);
+
+    if ((lengthOfAddress == 0) || (lengthOfLine < 4) || ((lengthOfLine % 2) != 0))
+    {
+        Flag = 0;  /* Invalid S-type or line length */
+    }
+
+    /* Check every character after the S-type */
+    for (index = 2; (Flag == 1) && (index < lengthOfLine); index++)
+    {
+        if (CheckHexCharacter(line[index]) == 0)
+        {
+            Flag = 0;  /* Invalid character */
+        }
+    }
+
+    if (Flag == 1)
+    {
+        byteCount = ReadSrecHexByte(&line[2]);
+        if ((byteCount < (lengthOfAddress + 1)) || ((byteCount * 2) != (lengthOfLine - 4)))
+        {
+            Flag = 0;  /* Byte count error */
+        }
+    }
+
+    if (Flag == 1)
+    {
+        sum = (uint8_t)byteCount;
+        decoded->address = 0;
+        decoded->lengthOfData = byteCount - lengthOfAddress - 1;
+
+        /* Convert address, data and checksum, accumulating the sum */
+        for (index = 0; index < byteCount; index++)
+        {
+            value = ReadSrecHexByte(&line[4 + (index * 2)]);
+            sum += value;
+            if (index < lengthOfAddress)
+            {
+                decoded->address = (decoded->address << 8) | value;
+            }
+            else if (index < (byteCount - 1))
+            {
+                decoded->data[index - lengthOfAddress] = value;
+            }
+        }
+
+        /* Count, address, data and checksum add up to 0xFF */
+        if (sum != 0xFF)
+        {
+            Flag = 0;  /* Checksum mismatch */
+        }
+
+        /* Data must end inside the address space of the S-type, never wrap to address 0 */
+        if (((decoded->type == S1) || (decoded->type == S2) || (decoded->type == S3)) &&
+            (((uint64_t)decoded->address + decoded->lengthOfData) > ((uint64_t)1 << (lengthOfAddress * 8))))
+        {
+            Flag = 0;  /* Data beyond the end of the address space */
+        }
+    }
+
+    return Flag;
+}
+
+/**
+ * @brief: Encode an S-record line from its fields
+ *
+ * @param[in] decoded: The fields of the record.
+ * @param[out] line: The encoded line.
+ * @return: The number of characters written, without the terminator.
+ */
+extern uint32_t EncodeSrecLine(const SrecData* decoded, char* line)
+{
+    static const char typeDigit[] = "?012356789";  /* Indexed by SrecTpye */
+    uint32_t lengthOfAddress;
+    uint32_t lengthOfLine;
+    uint32_t index;
+    uint8_t byteCount;
+    uint8_t sum;
+    uint8_t value;
+
+    lengthOfAddress = GetAddressLength(decoded->type);
+    byteCount = (uint8_t)(lengthOfAddress + decoded->lengthOfData + 1);
+    sum = byteCount;
+
+    line[0] = 'S';
+    line[1] = typeDigit[decoded->type];
+    WriteSrecHexByte(&line[2], byteCount);
+    lengthOfLine = 4;
+
+    /* Address, most significant byte first */
+    for (index = lengthOfAddress; index > 0; index--)
+    {
+        value = (uint8_t)(decoded->address >> ((index - 1) * 8));
+        sum += value;
+        WriteSrecHexByte(&line[lengthOfLine], value);
+        lengthOfLine += 2;
+    }
+
+    /* Data */
+    for (index = 0; index < decoded->lengthOfData; index++)
+    {
+        value = decoded->data[index];
+        sum += value;
+        WriteSrecHexByte(&line[lengthOfLine], value);
+        lengthOfLine += 2;
+    }
+
+    /* Checksum */
+    value = 0xFF - sum;
+    WriteSrecHexByte(&line[lengthOfLine], value);
+    lengthOfLine += 2;
+    line[lengthOfLine++] = '\n';
+    line[lengthOfLine] = '\0';
+
+    return lengthOfLine;
+}
+
+/**
+ * @brief: Convert a pair of hexadecimal characters to their integer value
+ *
+ * @param[in] hexadecimal: The pair of hexadecimal characters, already checked.
+ * @return: The integer value of the hexadecimal pair.
+ */
+extern uint8_t ReadSrecHexByte(const char* hexadecimal)
+{
+    /* Shift high digit and add low digit */
+    return (uint8_t)((ConvertHexToIntDigit(hexadecimal[0]) << 4) + ConvertHexToIntDigit(hexadecimal[1]));
+}
+
+/**
+ * @brief: Write a value as a pair of upper-case hexadecimal characters
+ *
+ * @param[out] hexadecimal: The pair of characters.
+ * @param[in] value: The value to write.
+ */
+extern void WriteSrecHexByte(char* hexadecimal, uint8_t value)
+{
+    static const char hexDigit[] = "0123456789ABCDEF";
+
+    hexadecimal[0] = hexDigit[value >> 4];
+    hexadecimal[1] = hexDigit[value & 0x0F];
+}
+
 /*******************************************************************************
 * EOF
 *******************************************************************************/
@@ -10,9 +10,14 @@
 #include <string.h>
 #include <stdint.h>
 
-#define LENGTH_OF_LINE    514
+#define LENGTH_OF_LINE    516  /* "Sx", 255 bytes in hex, newline and terminator */
+#define LENGTH_OF_ADDRESS 10
+#define MAX_BYTE_COUNT    255
 #define WORTHLESS         -1
 
+/* Value of each character as a hexadecimal digit, 0xFF if it is not one */
+extern const uint8_t SrecHexValue[256];
+
 /*******************************************************************************
 * Enum
 *******************************************************************************/
@@ -49,6 +54,36 @@ typedef enum
     S3_TYPE = 4  /**< S3 record type */
 } DataRecordType;
 
+/*******************************************************************************
+* Struct
+*******************************************************************************/
+
+/**
+ * @brief: Struct to store the result of parsing one line of the S-record file
+ *
+ * The caller fills numberOfLine and numberOfData before the line is checked,
+ * the remaining fields are filled by CheckSrecRecord.
+ */
+typedef struct
+{
+    uint32_t numberOfLine;            /**< Line number in the S-record file */
+    uint32_t numberOfData;            /**< Number of S1/S2/S3 records before this line */
+    char address[LENGTH_OF_ADDRESS];  /**< Address field of the line */
+    char data[LENGTH_OF_LINE];        /**< Data field of the line */
+    const char* errorMessage;         /**< Validation result of the line */
+} SrecRecord;
+
+/**
+ * @brief: Struct to store the decoded fields of one S-record line
+ */
+typedef struct
+{
+    SrecTpye type;                  /**< S-type of the line */
+    uint32_t address;               /**< Address field of the line */
+    uint32_t lengthOfData;          /**< Number of data bytes */
+    uint8_t data[MAX_BYTE_COUNT];   /**< Data bytes of the line */
+} SrecData;
+
 /*******************************************************************************
 * API
 *******************************************************************************/
@@ -126,6 +161,18 @@ extern uint8_t CheckLineCount(FILE* srecfile);
  */
 extern DataRecordType CheckDataRecord(FILE* srecfile);
 
+/**
+ * @brief: To select the predominant data record type from the record counts
+ *
+ * @param[in] numberOfS1: The number of S1 records.
+ * @param[in] numberOfS2: The number of S2 records.
+ * @param[in] numberOfS3: The number of S3 records.
+ * @param[out] None
+ * @param[inout] None
+ * @return: The most frequent data record type, S1 then S2 first on a tie.
+ */
+extern DataRecordType SelectDataRecord(uint32_t numberOfS1, uint32_t numberOfS2, uint32_t numberOfS3);
+
 /**
  * @brief: To check if the S-record line terminates correctly
  *
@@ -152,6 +199,136 @@ extern uint8_t CheckSrecTerminate(const char* line, DataRecordType recordType);
  */
 extern uint8_t CheckHexaLine(const char* line, uint32_t lengthOfLine);
 
+/**
+ * @brief: To check the count field of an S5/S6 line
+ *
+ * This function checks if the count stored in an S5 or S6 line matches the number of data records before it.
+ *
+ * @param[in] line: The S5 or S6 line from the S-record file.
+ * @param[in] numberOfLineData: The number of S1/S2/S3 records before the line.
+ * @param[out] None
+ * @param[inout] None
+ * @return: 1 if the line count is correct, 0 otherwise.
+ */
+extern uint8_t CheckLineCountSrec(const char* line, uint32_t numberOfLineData);
+
+/**
+ * @brief: To get the length of the address field shown in the parsing report
+ *
+ * The address width follows the data record type of the file, except S5 lines which always use 4 characters.
+ *
+ * @param[in] stype: The S-type of the line.
+ * @param[in] typeOfData: The data record type of the file.
+ * @param[out] None
+ * @param[inout] None
+ * @return: The number of address characters (4, 6 or 8).
+ */
+extern uint32_t GetLengthOfAddress(SrecTpye stype, DataRecordType typeOfData);
+
+/**
+ * @brief: To check if a data line falls in an address window
+ *
+ * This function only converts the byte count and address fields of the line, the rest of the line is not read.
+ *
+ * @param[in] line: The line from the S-record file.
+ * @param[in] lengthOfAddress: The number of address characters.
+ * @param[in] firstAddress: The first address of the window.
+ * @param[in] lastAddress: The last address of the window.
+ * @param[out] None
+ * @param[inout] None
+ * @return: 1 if the data overlaps the window or the fields can't be converted, 0 otherwise.
+ */
+extern uint8_t CheckSrecWindow(const char* line, uint32_t lengthOfAddress, uint32_t firstAddress, uint32_t lastAddress);
+
+/**
+ * @brief: To validate one line of the S-record file and extract its fields
+ *
+ * This function runs every line check in order, stores the first error found and splits the line into address and data.
+ *
+ * @param[in] typeOfData: The data record type of the file.
+ * @param[out] None
+ * @param[inout] line: The line from the S-record file, the trailing newline is removed.
+ * @param[inout] record: The record holding the line number and data count, receives the fields and the result.
+ * @return: None
+ */
+extern void CheckSrecRecord(char* line, DataRecordType typeOfData, SrecRecord* record);
+
+/**
+ * @brief: To print the header of the parsing report
+ *
+ * @param[in] None
+ * @param[out] None
+ * @param[inout] output: The stream that receives the header.
+ * @return: None
+ */
+extern void PrintSrecHeader(FILE* output);
+
+/**
+ * @brief: To print one parsed record of the parsing report
+ *
+ * @param[in] record: The parsed record.
+ * @param[out] None
+ * @param[inout] output: The stream that receives the record.
+ * @return: None
+ */
+extern void PrintSrecRecord(FILE* output, const SrecRecord* record);
+
+/**
+ * @brief: To get the length of the address field of an S-type
+ *
+ * @param[in] type: The S-type of the line.
+ * @param[out] None
+ * @param[inout] None
+ * @return: The number of address bytes (2, 3 or 4), 0 if the S-type is invalid.
+ */
+extern uint32_t GetAddressLength(SrecTpye type);
+
+/**
+ * @brief: To decode the fields of an S-record line
+ *
+ * This function checks the S-type, hexadecimal characters, byte count and checksum of the line and converts
+ * the address and data fields to binary. A data record running past the end of its 16, 24 or 32-bit address
+ * space is invalid.
+ *
+ * @param[in] line: The line from the S-record file, a trailing newline is allowed.
+ * @param[out] decoded: The decoded fields of the line.
+ * @param[inout] None
+ * @return: 1 if the line is a valid record, 0 otherwise.
+ */
+extern uint8_t DecodeSrecLine(const char* line, SrecData* decoded);
+
+/**
+ * @brief: To encode an S-record line from its fields
+ *
+ * This function writes the S-type, byte count, address, data and checksum of the record followed by a newline.
+ *
+ * @param[in] decoded: The fields of the record, the data must fit the 255 byte count limit.
+ * @param[out] line: The encoded line, at least LENGTH_OF_LINE characters.
+ * @param[inout] None
+ * @return: The number of characters written, without the terminator.
+ */
+extern uint32_t EncodeSrecLine(const SrecData* decoded, char* line);
+
+/**
+ * @brief: To convert a pair of hexadecimal characters to a byte
+ *
+ * @param[in] hexadecimal: The pair of characters, checked with CheckHexaLine first.
+ * @param[out] None
+ * @param[inout] None
+ * @return: The value of the pair.
+ */
+extern uint8_t ReadSrecHexByte(const char* hexadecimal);
+
+/**
+ * @brief: To write a byte as a pair of upper-case hexadecimal characters
+ *
+ * @param[in] value: The byte to write.
+ * @param[out] hexadecimal: The pair of characters, not terminated.
+ * @param[inout] None
+ * @return: None
+ */
+extern void WriteSrecHexByte(char* hexadecimal, uint8_t value);
+
 #endif // !SCRECLIB_H
 
 /*******************************************************************************
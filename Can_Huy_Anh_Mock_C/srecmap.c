@@ -0,0 +1,215 @@
+/*******************************************************************************
+* Include
+*******************************************************************************/
+
+#ifndef _WIN32
+/* POSIX declarations and 64-bit file offsets */
+#define _POSIX_C_SOURCE   200809L
+#define _FILE_OFFSET_BITS 64
+#endif
+#include "srecmap.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*******************************************************************************
+* Function
+*******************************************************************************/
+
+#ifdef _WIN32
+
+/**
+ * @brief: Map a whole file in memory
+ *
+ * @param[in] fileName: The file to map.
+ * @param[in] writable: 1 to map the file read-write, 0 to map it read-only.
+ * @param[out] map: The mapped file.
+ * @return: 1 if the file is mapped, 0 otherwise.
+ */
+extern uint8_t OpenSrecMap(SrecMap* map, const char* fileName, uint8_t writable)
+{
+    LARGE_INTEGER size;
+
+    map->data = NULL;
+    map->size = 0;
+    map->writable = writable;
+    map->mapping = NULL;
+    map->file = CreateFileA(fileName, (writable == 1) ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+                            FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (map->file == INVALID_HANDLE_VALUE)
+    {
+        map->file = NULL;
+        return 0;
+    }
+
+    if ((GetFileSizeEx(map->file, &size) == 0) || ((uint64_t)size.QuadPart > SIZE_MAX))
+    {
+        CloseSrecMap(map);
+        return 0;
+    }
+    map->size = (size_t)size.QuadPart;
+
+    /* An empty file can't be mapped and has nothing to read */
+    if (map->size > 0)
+    {
+        map->mapping = CreateFileMappingA(map->file, NULL, (writable == 1) ? PAGE_READWRITE : PAGE_READONLY, 0, 0, NULL);
+        if (map->mapping != NULL)
+        {
+            map->data = (uint8_t*)MapViewOfFile(map->mapping, (writable == 1) ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+        }
+        if (map->data == NULL)
+        {
+            CloseSrecMap(map);
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * @brief: Write a modified range of a read-write mapping back to the file
+ *
+ * @param[in] offset: The offset of the first modified byte.
+ * @param[in] length: The number of modified bytes.
+ * @param[inout] map: The mapped file.
+ * @return: 1 if the range is written, 0 otherwise.
+ */
+extern uint8_t FlushSrecMap(SrecMap* map, size_t offset, size_t length)
+{
+    if ((map->writable != 1) || (length == 0))
+    {
+        return (map->writable == 1) ? 1 : 0;
+    }
+
+    return (FlushViewOfFile(map->data + offset, length) != 0) ? 1 : 0;
+}
+
+/**
+ * @brief: Unmap a file and close it
+ *
+ * @param[inout] map: The mapped file.
+ */
+extern void CloseSrecMap(SrecMap* map)
+{
+    if (map->data != NULL)
+    {
+        UnmapViewOfFile(map->data);
+    }
+    if (map->mapping != NULL)
+    {
+        CloseHandle(map->mapping);
+    }
+    if (map->file != NULL)
+    {
+        CloseHandle(map->file);
+    }
+
+    map->data = NULL;
+    map->mapping = NULL;
+    map->file = NULL;
+    map->size = 0;
+}
+
+#else
+
+/**
+ * @brief: Map a whole file in memory
+ *
+ * @param[in] fileName: The file to map.
+ * @param[in] writable: 1 to map the file read-write, 0 to map it read-only.
+ * @param[out] map: The mapped file.
+ * @return: 1 if the file is mapped, 0 otherwise.
+ */
+extern uint8_t OpenSrecMap(SrecMap* map, const char* fileName, uint8_t writable)
+{
+    struct stat status;
+    void* data;
+
+    map->data = NULL;
+    map->size = 0;
+    map->writable = writable;
+    map->file = open(fileName, (writable == 1) ? O_RDWR : O_RDONLY);
+    if (map->file < 0)
+    {
+        return 0;
+    }
+
+    if ((fstat(map->file, &status) != 0) || ((uint64_t)status.st_size > SIZE_MAX))
+    {
+        CloseSrecMap(map);
+        return 0;
+    }
+    map->size = (size_t)status.st_size;
+
+    /* An empty file can't be mapped and has nothing to read */
+    if (map->size > 0)
+    {
+        data = mmap(NULL, map->size, (writable == 1) ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, map->file, 0);
+        if (data == MAP_FAILED)
+        {
+            CloseSrecMap(map);
+            return 0;
+        }
+        map->data = (uint8_t*)data;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief: Write a modified range of a read-write mapping back to the file
+ *
+ * @param[in] offset: The offset of the first modified byte.
+ * @param[in] length: The number of modified bytes.
+ * @param[inout] map: The mapped file.
+ * @return: 1 if the range is written, 0 otherwise.
+ */
+extern uint8_t FlushSrecMap(SrecMap* map, size_t offset, size_t length)
+{
+    size_t pageSize;
+    size_t start;
+
+    if ((map->writable != 1) || (length == 0))
+    {
+        return (map->writable == 1) ? 1 : 0;
+    }
+
+    /* msync needs a page-aligned start */
+    pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    start = offset - (offset % pageSize);
+
+    return (msync(map->data + start, (offset - start) + length, MS_SYNC) == 0) ? 1 : 0;
+}
+
+/**
+ * @brief: Unmap a file and close it
+ *
+ * @param[inout] map: The mapped file.
+ */
+extern void CloseSrecMap(SrecMap* map)
+{
+    if (map->data != NULL)
+    {
+        munmap(map->data, map->size);
+    }
+    if (map->file >= 0)
+    {
+        close(map->file);
+    }
+
+    map->data = NULL;
+    map->file = -1;
+    map->size = 0;
+}
+
+#endif
+
+/*******************************************************************************
+* EOF
+*******************************************************************************/
@@ -0,0 +1,72 @@
+/*******************************************************************************
+* Include
+*******************************************************************************/
+
+#pragma once
+#ifndef SRECMAP_H
+#define SRECMAP_H
+#include "sreclib.h"
+
+/*******************************************************************************
+* Struct
+*******************************************************************************/
+
+/**
+ * @brief: A file mapped in memory
+ */
+typedef struct
+{
+    uint8_t* data;      /**< Content of the file, NULL if the file is empty */
+    size_t size;        /**< Size of the file in bytes */
+    uint8_t writable;   /**< 1 if the mapping can be written back to the file */
+#ifdef _WIN32
+    void* file;         /**< Handle of the file */
+    void* mapping;      /**< Handle of the file mapping */
+#else
+    int file;           /**< Descriptor of the file */
+#endif
+} SrecMap;
+
+/*******************************************************************************
+* API
+*******************************************************************************/
+
+/**
+ * @brief: To map a whole file in memory
+ *
+ * @param[in] fileName: The file to map.
+ * @param[in] writable: 1 to map the file read-write, 0 to map it read-only.
+ * @param[out] map: The mapped file.
+ * @param[inout] None
+ * @return: 1 if the file is mapped, 0 otherwise.
+ */
+extern uint8_t OpenSrecMap(SrecMap* map, const char* fileName, uint8_t writable);
+
+/**
+ * @brief: To write a modified range of a read-write mapping back to the file
+ *
+ * Only the pages containing the range are written.
+ *
+ * @param[in] offset: The offset of the first modified byte.
+ * @param[in] length: The number of modified bytes.
+ * @param[out] None
+ * @param[inout] map: The mapped file.
+ * @return: 1 if the range is written, 0 otherwise.
+ */
+extern uint8_t FlushSrecMap(SrecMap* map, size_t offset, size_t length);
+
+/**
+ * @brief: To unmap a file and close it
+ *
+ * @param[in] None
+ * @param[out] None
+ * @param[inout] map: The mapped file.
+ * @return: None
+ */
+extern void CloseSrecMap(SrecMap* map);
+
+#endif // !SRECMAP_H
+
+/*******************************************************************************
+* EOF
+*******************************************************************************/
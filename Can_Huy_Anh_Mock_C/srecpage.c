@@ -0,0 +1,327 @@
+/*******************************************************************************
+* Include
+*******************************************************************************/
+
+#include "srecpage.h"
+#include <stdlib.h>
+
+/* Number of page entries allocated at once */
+#define SREC_PAGE_GROWTH 64
+
+/*******************************************************************************
+* Prototype
+*******************************************************************************/
+
+/**
+ * @brief: Check if a value is a non-zero power of two
+ *
+ * @param[in] value: The value to check.
+ * @return: 1 if the value is a power of two, 0 otherwise.
+ */
+static uint8_t CheckPowerOfTwo(uint32_t value)
+{
+    return ((value != 0) && ((value & (value - 1)) == 0)) ? 1 : 0;
+}
+
+/**
+ * @brief: Find the page starting at an address, creating it if needed
+ *
+ * Records are mostly in address order, so the last page written and the end of the list are checked
+ * before the binary search.
+ *
+ * @param[inout] image: The page image.
+ * @param[in] address: The page-aligned address.
+ * @return: The page, or NULL if it can't be allocated.
+ */
+static SrecPage* GetPage(SrecPageImage* image, uint32_t address)
+{
+    SrecPage* page;
+    SrecPage* grown;
+    uint32_t low;
+    uint32_t high;
+    uint32_t middle;
+
+    if ((image->numberOfPage > 0) && (image->page[image->lastPage].address == address))
+    {
+        return &image->page[image->lastPage];
+    }
+
+    /* Find the insert position */
+    if ((image->numberOfPage == 0) || (image->page[image->numberOfPage - 1].address < address))
+    {
+        low = image->numberOfPage;
+    }
+    else
+    {
+        low = 0;
+        high = image->numberOfPage;
+        while (low < high)
+        {
+            middle = low + ((high - low) / 2);
+            if (image->page[middle].address < address)
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+
+        if (image->page[low].address == address)
+        {
+            image->lastPage = low;
+            return &image->page[low];
+        }
+    }
+
+    /* Create the page at position low */
+    if (image->numberOfPage == image->capacityOfPage)
+    {
+        grown = (SrecPage*)realloc(image->page, sizeof(SrecPage) * (image->capacityOfPage + SREC_PAGE_GROWTH));
+        if (grown == NULL)
+        {
+            return NULL;
+        }
+        image->page = grown;
+        image->capacityOfPage += SREC_PAGE_GROWTH;
+    }
+
+    page = &image->page[low];
+    memmove(page + 1, page, sizeof(SrecPage) * (image->numberOfPage - low));
+    page->address = address;
+    page->data = (uint8_t*)malloc(image->pageSize);
+    if (page->data == NULL)
+    {
+        memmove(page, page + 1, sizeof(SrecPage) * (image->numberOfPage - low));
+        return NULL;
+    }
+    memset(page->data, image->fill, image->pageSize);
+
+    image->numberOfPage++;
+    image->lastPage = low;
+
+    return page;
+}
+
+/*******************************************************************************
+* Function
+*******************************************************************************/
+
+/**
+ * @brief: Initialize an empty page image
+ *
+ * @param[in] pageSize: The size of a program page.
+ * @param[in] sectorSize: The size of an erase sector.
+ * @param[in] fill: The value used to pad the pages.
+ * @param[out] image: The page image.
+ * @return: 1 if the sizes are valid, 0 otherwise.
+ */
+extern uint8_t InitSrecPageImage(SrecPageImage* image, uint32_t pageSize, uint32_t sectorSize, uint8_t fill)
+{
+    image->pageSize = pageSize;
+    image->sectorSize = sectorSize;
+    image->fill = fill;
+    image->numberOfPage = 0;
+    image->capacityOfPage = 0;
+    image->lastPage = 0;
+    image->page = NULL;
+
+    return ((CheckPowerOfTwo(pageSize) == 1) && (CheckPowerOfTwo(sectorSize) == 1) && (sectorSize >= pageSize)) ? 1 : 0;
+}
+
+/**
+ * @brief: Copy the data of a decoded record into its pages
+ *
+ * @param[in] decoded: The decoded S1/S2/S3 record.
+ * @param[inout] image: The page image.
+ * @return: 1 if the data was copied, 0 if a page can't be allocated.
+ */
+extern uint8_t AddSrecPageData(SrecPageImage* image, const SrecData* decoded)
+{
+    SrecPage* page;
+    uint32_t address;
+    uint32_t offset;
+    uint32_t lengthOfCopy;
+    uint32_t index;
+
+    index = 0;
+    while (index < decoded->lengthOfData)
+    {
+        address = decoded->address + index;
+        offset = address & (image->pageSize - 1);
+
+        /* Copy up to the end of the page */
+        lengthOfCopy = image->pageSize - offset;
+        if (lengthOfCopy > (decoded->lengthOfData - index))
+        {
+            lengthOfCopy = decoded->lengthOfData - index;
+        }
+
+        page = GetPage(image, address - offset);
+        if (page == NULL)
+        {
+            return 0;
+        }
+
+        memcpy(&page->data[offset], &decoded->data[index], lengthOfCopy);
+        index += lengthOfCopy;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief: Load the data records of an S-record file into a page image
+ *
+ * @param[in] inputFile: The S-record file.
+ * @param[inout] image: The initialized page image.
+ * @return: 1 if every line was loaded, 0 otherwise.
+ */
+extern uint8_t LoadSrecPageImage(SrecPageImage* image, const char* inputFile)
+{
+    char line[LENGTH_OF_LINE];
+    SrecData decoded;
+    uint32_t numberOfLine;
+    uint8_t Flag;
+    FILE* srecfile;
+
+    srecfile = fopen(inputFile, "r");
+    if (srecfile == NULL)
+    {
+        perror("ERROR: Can't open this file");
+        return 0;
+    }
+
+    Flag = 1;
+    numberOfLine = 0;
+
+    while (fgets(line, sizeof(line), srecfile) != NULL)
+    {
+        numberOfLine++;
+
+        if (DecodeSrecLine(line, &decoded) != 1)
+        {
+            fprintf(stderr, "Line %u: invalid record\n", numberOfLine);
+            Flag = 0;
+        }
+        else if ((decoded.type == S1) || (decoded.type == S2) || (decoded.type == S3))
+        {
+            if (AddSrecPageData(image, &decoded) != 1)
+            {
+                perror("ERROR: Can't allocate a page");
+                Flag = 0;
+                break;
+            }
+        }
+    }
+
+    fclose(srecfile);
+
+    return Flag;
+}
+
+/**
+ * @brief: Write the dirty sectors and pages of a page image
+ *
+ * @param[in] image: The page image.
+ * @param[inout] output: The stream that receives the list.
+ */
+extern void WriteSrecPageImage(const SrecPageImage* image, FILE* output)
+{
+    const SrecPage* page;
+    uint32_t sector;
+    uint32_t index;
+    uint32_t offset;
+
+    for (index = 0; index < image->numberOfPage; index++)
+    {
+        page = &image->page[index];
+        sector = page->address & ~(image->sectorSize - 1);
+
+        /* Pages are sorted, so a new sector starts when the sector address changes */
+        if ((index == 0) || (sector != (image->page[index - 1].address & ~(image->sectorSize - 1))))
+        {
+            fprintf(output, "SECTOR %08X %08X\n", sector, image->sectorSize);
+        }
+
+        fprintf(output, "PAGE   %08X %08X ", page->address, image->pageSize);
+        for (offset = 0; offset < image->pageSize; offset++)
+        {
+            fprintf(output, "%02X", page->data[offset]);
+        }
+        fprintf(output, "\n");
+    }
+}
+
+/**
+ * @brief: Release the pages of a page image
+ *
+ * @param[inout] image: The page image.
+ */
+extern void FreeSrecPageImage(SrecPageImage* image)
+{
+    uint32_t index;
+
+    for (index = 0; index < image->numberOfPage; index++)
+    {
+        free(image->page[index].data);
+    }
+    free(image->page);
+
+    image->page = NULL;
+    image->numberOfPage = 0;
+    image->capacityOfPage = 0;
+    image->lastPage = 0;
+}
+
+/**
+ * @brief: Group the data of an S-record file into flash pages and list the dirty sectors and pages
+ *
+ * @param[in] inputFile: The S-record file.
+ * @param[in] outputFile: The page list file to write.
+ * @param[in] pageSize: The page size in bytes.
+ * @param[in] sectorSize: The erase sector size in bytes.
+ * @return: 1 if every data record was placed and the list written, 0 otherwise.
+ */
+extern uint8_t PageSrec(const char* inputFile, const char* outputFile, uint32_t pageSize, uint32_t sectorSize)
+{
+    SrecPageImage image;
+    FILE* output;
+    uint8_t Flag;
+
+    if (InitSrecPageImage(&image, pageSize, sectorSize, SREC_PAGE_FILL) != 1)
+    {
+        fprintf(stderr, "ERROR: Page and sector sizes must be powers of two, sector not smaller than page\n");
+        return 0;
+    }
+
+    /* A page list meant for flashing must not lose records, so nothing is written unless every line is valid */
+    Flag = LoadSrecPageImage(&image, inputFile);
+    if (Flag != 1)
+    {
+        fprintf(stderr, "ERROR: %s not paged, nothing written\n", inputFile);
+    }
+    else
+    {
+        output = fopen(outputFile, "w");
+        if (output == NULL)
+        {
+            perror("ERROR: Can't open this file");
+            Flag = 0;
+        }
+        else
+        {
+            WriteSrecPageImage(&image, output);
+            fclose(output);
+        }
+    }
+
+    FreeSrecPageImage(&image);
+
+    return Flag;
+}
+
+/*******************************************************************************
+* EOF
+*******************************************************************************/
@@ -0,0 +1,120 @@
+/*******************************************************************************
+* Include
+*******************************************************************************/
+
+#pragma once
+#ifndef SRECPAGE_H
+#define SRECPAGE_H
+#include "sreclib.h"
+
+#define SREC_PAGE_FILL 0xFF  /* Value of erased flash, used to pad the pages */
+
+/*******************************************************************************
+* Struct
+*******************************************************************************/
+
+/**
+ * @brief: One flash page touched by the S-record data
+ */
+typedef struct
+{
+    uint32_t address;  /**< Start address of the page, aligned to the page size */
+    uint8_t* data;     /**< Page content, bytes without data hold the fill value */
+} SrecPage;
+
+/**
+ * @brief: Dirty pages of an S-record file, sorted by address
+ */
+typedef struct
+{
+    uint32_t pageSize;        /**< Size of a program page, power of two */
+    uint32_t sectorSize;      /**< Size of an erase sector, power of two multiple of pageSize */
+    uint8_t fill;             /**< Value used to pad the pages */
+    uint32_t numberOfPage;    /**< Number of dirty pages */
+    uint32_t capacityOfPage;  /**< Number of allocated page entries */
+    uint32_t lastPage;        /**< Index of the last page written, checked first */
+    SrecPage* page;           /**< Dirty pages sorted by address */
+} SrecPageImage;
+
+/*******************************************************************************
+* API
+*******************************************************************************/
+
+/**
+ * @brief: To initialize an empty page image
+ *
+ * @param[in] pageSize: The size of a program page, power of two.
+ * @param[in] sectorSize: The size of an erase sector, power of two and at least pageSize.
+ * @param[in] fill: The value used to pad the pages.
+ * @param[out] image: The page image.
+ * @param[inout] None
+ * @return: 1 if the sizes are valid, 0 otherwise.
+ */
+extern uint8_t InitSrecPageImage(SrecPageImage* image, uint32_t pageSize, uint32_t sectorSize, uint8_t fill);
+
+/**
+ * @brief: To copy the data of a decoded record into its pages
+ *
+ * This function splits the data on page boundaries and creates the pages it touches.
+ *
+ * @param[in] decoded: The decoded S1/S2/S3 record.
+ * @param[out] None
+ * @param[inout] image: The page image.
+ * @return: 1 if the data was copied, 0 if a page can't be allocated.
+ */
+extern uint8_t AddSrecPageData(SrecPageImage* image, const SrecData* decoded);
+
+/**
+ * @brief: To load the data records of an S-record file into a page image
+ *
+ * Every invalid line is reported on stderr and skipped.
+ *
+ * @param[in] inputFile: The S-record file.
+ * @param[out] None
+ * @param[inout] image: The initialized page image.
+ * @return: 1 if every line was loaded, 0 otherwise.
+ */
+extern uint8_t LoadSrecPageImage(SrecPageImage* image, const char* inputFile);
+
+/**
+ * @brief: To write the dirty sectors and pages of a page image
+ *
+ * Each dirty sector is listed once, followed by its dirty pages and their content in hexadecimal.
+ *
+ * @param[in] image: The page image.
+ * @param[out] None
+ * @param[inout] output: The stream that receives the list.
+ * @return: None
+ */
+extern void WriteSrecPageImage(const SrecPageImage* image, FILE* output);
+
+/**
+ * @brief: To release the pages of a page image
+ *
+ * @param[in] None
+ * @param[out] None
+ * @param[inout] image: The page image.
+ * @return: None
+ */
+extern void FreeSrecPageImage(SrecPageImage* image);
+
+/**
+ * @brief: To group the data of an S-record file into flash pages and list the dirty sectors and pages
+ *
+ * Every invalid line is reported on stderr and no page list is written then, so no record is lost.
+ *
+ * @param[in] inputFile: The S-record file.
+ * @param[in] outputFile: The page list file to write.
+ * @param[in] pageSize: The page size in bytes, a power of two.
+ * @param[in] sectorSize: The erase sector size in bytes, a power of two not smaller than pageSize.
+ * @param[out] None
+ * @param[inout] None
+ * @return: 1 if every data record was placed and the list written, 0 otherwise.
+ */
+extern uint8_t PageSrec(const char* inputFile, const char* outputFile, uint32_t pageSize, uint32_t sectorSize);
+
+#endif // !SRECPAGE_H
+
+/*******************************************************************************
+* EOF
+*******************************************************************************/
@@ -0,0 +1,323 @@
+/*******************************************************************************
+* Include
+*******************************************************************************/
+
+#include "srecpipe.h"
+#include "srecfast.h"
+#include "srecinput.h"
+#include "srecring.h"
+#include <stdlib.h>
+#include <threads.h>
+
+/*******************************************************************************
+* Struct
+*******************************************************************************/
+
+/**
+ * @brief: A batch of raw lines and their parsed records
+ */
+typedef struct
+{
+    uint32_t numberOfLine;                                    /**< Number of lines in the batch */
+    char line[SREC_PIPE_LINE_OF_BATCH][LENGTH_OF_LINE];       /**< Raw lines read from the file */
+    SrecRecord record[SREC_PIPE_LINE_OF_BATCH];               /**< Parsed records of the lines */
+} SrecBatch;
+
+/**
+ * @brief: Shared state of the pipeline
+ *
+ * Batch n is sent to validator (n % numberOfValidator), so the writer restores the file order by
+ * popping the validators' output rings in the same round-robin order.
+ */
+typedef struct
+{
+    SrecInput* srecfile;                           /**< File being parsed, plain or gzip-compressed */
+    FILE* output;                                  /**< Report file */
+    SrecRecordChecker checkRecord;                 /**< Line checker specialized for the file */
+    uint32_t numberOfValidator;                    /**< Number of validator threads */
+    uint8_t isComplete;                            /**< 1 if the whole input was read, set by the reader before its end */
+    SrecBatch* batch;                              /**< Pool of batches */
+    SrecRing freeRing;                             /**< Writer -> reader: empty batches */
+    SrecRing inRing[SREC_PIPE_MAX_VALIDATOR];      /**< Reader -> validator: batches to validate */
+    SrecRing outRing[SREC_PIPE_MAX_VALIDATOR];     /**< Validator -> writer: validated batches */
+} SrecPipeline;
+
+/**
+ * @brief: Argument of a validator thread
+ */
+typedef struct
+{
+    SrecPipeline* pipeline;  /**< Shared state of the pipeline */
+    uint32_t index;          /**< Index of the validator */
+} SrecValidatorArg;
+
+/*******************************************************************************
+* Prototype
+*******************************************************************************/
+
+/**
+ * @brief: Reader stage, fill batches with lines from the file
+ *
+ * The reader also numbers the lines and counts the data records before each line, which are the
+ * only values a line check needs from the lines before it.
+ *
+ * @param[in] arg: The pipeline.
+ * @return: 0
+ */
+static int ReadStage(void* arg)
+{
+    SrecPipeline* pipeline = (SrecPipeline*)arg;
+    SrecBatch* batch;
+    SrecTpye stype;
+    uint32_t indexOfBatch;
+    uint32_t numberOfBatch;
+    uint32_t numberOfLine;
+    uint32_t numberOfData;
+    uint8_t endOfFile;
+
+    numberOfBatch = 0;
+    numberOfLine = 0;
+    numberOfData = 0;
+    endOfFile = 0;
+
+    while (endOfFile == 0)
+    {
+        indexOfBatch = PopRing(&pipeline->freeRing);
+        batch = &pipeline->batch[indexOfBatch];
+        batch->numberOfLine = 0;
+
+        /* Fill the batch until it is full or the file ends */
+        while ((batch->numberOfLine < SREC_PIPE_LINE_OF_BATCH) &&
+               (GetsSrecInput(batch->line[batch->numberOfLine], LENGTH_OF_LINE, pipeline->srecfile) != NULL))
+        {
+            numberOfLine++;
+            batch->record[batch->numberOfLine].numberOfLine = numberOfLine;
+            batch->record[batch->numberOfLine].numberOfData = numberOfData;
+
+            stype = CheckSType(batch->line[batch->numberOfLine]);
+            if ((stype == S1) || (stype == S2) || (stype == S3))
+            {
+                numberOfData++;
+            }
+            batch->numberOfLine++;
+        }
+
+        if (batch->numberOfLine < SREC_PIPE_LINE_OF_BATCH)
+        {
+            endOfFile = 1;
+        }
+
+        if (batch->numberOfLine > 0)
+        {
+            PushRing(&pipeline->inRing[numberOfBatch % pipeline->numberOfValidator], indexOfBatch);
+            numberOfBatch++;
+        }
+    }
+
+    /* Published to the writer through the end markers */
+    pipeline->isComplete = CheckSrecInput(pipeline->srecfile);
+
+    /* Stop every validator, the one that would get the next batch tells the writer the file is done */
+    for (indexOfBatch = 0; indexOfBatch < pipeline->numberOfValidator; indexOfBatch++)
+    {
+        PushRing(&pipeline->inRing[indexOfBatch], SREC_RING_END);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief: Validator stage, check every line of the batches received from the reader
+ *
+ * @param[in] arg: The validator argument.
+ * @return: 0
+ */
+static int ValidateStage(void* arg)
+{
+    SrecValidatorArg* validator = (SrecValidatorArg*)arg;
+    SrecPipeline* pipeline = validator->pipeline;
+    SrecBatch* batch;
+    uint32_t indexOfBatch;
+    uint32_t index;
+
+    for (;;)
+    {
+        indexOfBatch = PopRing(&pipeline->inRing[validator->index]);
+        if (indexOfBatch == SREC_RING_END)
+        {
+            break;
+        }
+
+        batch = &pipeline->batch[indexOfBatch];
+        for (index = 0; index < batch->numberOfLine; index++)
+        {
+            pipeline->checkRecord(batch->line[index], &batch->record[index]);
+        }
+
+        PushRing(&pipeline->outRing[validator->index], indexOfBatch);
+    }
+
+    PushRing(&pipeline->outRing[validator->index], SREC_RING_END);
+
+    return 0;
+}
+
+/**
+ * @brief: Writer stage, print the validated batches in file order
+ *
+ * @param[inout] pipeline: The pipeline.
+ */
+static void WriteStage(SrecPipeline* pipeline)
+{
+    SrecBatch* batch;
+    uint32_t indexOfBatch;
+    uint32_t numberOfBatch;
+    uint32_t index;
+
+    PrintSrecHeader(pipeline->output);
+    PrintSrecHeader(stdout);
+
+    for (numberOfBatch = 0; ; numberOfBatch++)
+    {
+        indexOfBatch = PopRing(&pipeline->outRing[numberOfBatch % pipeline->numberOfValidator]);
+        if (indexOfBatch == SREC_RING_END)
+        {
+            break;
+        }
+
+        batch = &pipeline->batch[indexOfBatch];
+        for (index = 0; index < batch->numberOfLine; index++)
+        {
+            PrintSrecRecord(pipeline->output, &batch->record[index]);
+            PrintSrecRecord(stdout, &batch->record[index]);
+        }
+
+        /* Give the batch back to the reader */
+        PushRing(&pipeline->freeRing, indexOfBatch);
+    }
+
+    /* A corrupt or truncated input ends early, mark the report as incomplete */
+    if (pipeline->isComplete != 1)
+    {
+        fprintf(pipeline->output, "ERROR: Input ends early, the report is incomplete\n");
+        fprintf(stdout, "ERROR: Input ends early, the report is incomplete\n");
+    }
+}
+
+/*******************************************************************************
+* Function
+*******************************************************************************/
+
+/**
+ * @brief: Parse an S-record file with a reader/validator/writer pipeline
+ *
+ * @param[in] inputFile: The S-record file to parse.
+ * @param[in] outputFile: The report file to write.
+ * @param[in] numberOfValidator: The number of validator threads.
+ * @return: 1 if the file was parsed, 0 otherwise.
+ */
+extern uint8_t ParseSrecPipeline(const char* inputFile, const char* outputFile, uint32_t numberOfValidator)
+{
+    SrecPipeline* pipeline;
+    SrecValidatorArg validatorArg[SREC_PIPE_MAX_VALIDATOR];
+    thrd_t validatorThread[SREC_PIPE_MAX_VALIDATOR];
+    thrd_t readerThread;
+    uint32_t numberOfStarted;
+    uint32_t index;
+    uint8_t Flag;
+
+    if ((numberOfValidator == 0) || (numberOfValidator > SREC_PIPE_MAX_VALIDATOR))
+    {
+        fprintf(stderr, "ERROR: Number of validator must be 1 to %u\n", SREC_PIPE_MAX_VALIDATOR);
+        return 0;
+    }
+
+    pipeline = (SrecPipeline*)calloc(1, sizeof(SrecPipeline));
+    if (pipeline == NULL)
+    {
+        perror("ERROR: Can't allocate the pipeline");
+        return 0;
+    }
+
+    pipeline->numberOfValidator = numberOfValidator;
+    pipeline->batch = (SrecBatch*)malloc(sizeof(SrecBatch) * numberOfValidator * SREC_PIPE_BATCH_OF_VALIDATOR);
+    pipeline->srecfile = OpenSrecInput(inputFile);
+    pipeline->output = fopen(outputFile, "w");
+    Flag = 1;
+
+    if ((pipeline->batch == NULL) || (pipeline->srecfile == NULL) || (pipeline->output == NULL))
+    {
+        perror("ERROR: Can't open this file");
+        Flag = 0;
+    }
+    else
+    {
+        pipeline->checkRecord = GetSrecRecordChecker(CheckDataRecordInput(pipeline->srecfile));  /* Determine the type of data record. */
+        if (RewindSrecInput(pipeline->srecfile) != 1)  /* Rewind file to the beginning for processing. */
+        {
+            Flag = 0;
+        }
+
+        /* Every batch starts empty and owned by the reader */
+        for (index = 0; index < (numberOfValidator * SREC_PIPE_BATCH_OF_VALIDATOR); index++)
+        {
+            PushRing(&pipeline->freeRing, index);
+        }
+
+        /* Start the validators, then the reader */
+        for (numberOfStarted = 0; (Flag == 1) && (numberOfStarted < numberOfValidator); numberOfStarted++)
+        {
+            validatorArg[numberOfStarted].pipeline = pipeline;
+            validatorArg[numberOfStarted].index = numberOfStarted;
+            if (thrd_create(&validatorThread[numberOfStarted], ValidateStage, &validatorArg[numberOfStarted]) != thrd_success)
+            {
+                Flag = 0;
+                break;
+            }
+        }
+
+        if ((Flag == 1) && (thrd_create(&readerThread, ReadStage, pipeline) != thrd_success))
+        {
+            Flag = 0;
+        }
+
+        if (Flag == 1)
+        {
+            WriteStage(pipeline);
+            thrd_join(readerThread, NULL);
+            Flag = pipeline->isComplete;
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: Can't start the pipeline threads\n");
+
+            /* Stop the validators that are already running */
+            for (index = 0; index < numberOfStarted; index++)
+            {
+                PushRing(&pipeline->inRing[index], SREC_RING_END);
+            }
+        }
+
+        for (index = 0; index < numberOfStarted; index++)
+        {
+            thrd_join(validatorThread[index], NULL);
+        }
+    }
+
+    if (pipeline->srecfile != NULL)
+    {
+        CloseSrecInput(pipeline->srecfile);  /* Close the input file. */
+    }
+    if (pipeline->output != NULL)
+    {
+        fclose(pipeline->output);  /* Close the output file. */
+    }
+    free(pipeline->batch);
+    free(pipeline);
+
+    return Flag;
+}
+
+/*******************************************************************************
+* EOF
+*******************************************************************************/
@@ -0,0 +1,38 @@
+/*******************************************************************************
+* Include
+*******************************************************************************/
+
+#pragma once
+#ifndef SRECPIPE_H
+#define SRECPIPE_H
+#include "sreclib.h"
+
+#define SREC_PIPE_MAX_VALIDATOR      8    /* Maximum number of validator threads */
+#define SREC_PIPE_LINE_OF_BATCH      128  /* Number of lines carried by one batch */
+#define SREC_PIPE_BATCH_OF_VALIDATOR 4    /* Number of batches in flight per validator */
+
+/*******************************************************************************
+* API
+*******************************************************************************/
+
+/**
+ * @brief: To parse an S-record file with a reader/validator/writer pipeline
+ *
+ * This function reads the file on a reader thread, validates batches of lines on one or more validator
+ * threads and writes the report on the calling thread. The stages are connected by lock-free
+ * single-producer single-consumer ring buffers, the report is identical to the serial parser.
+ *
+ * @param[in] inputFile: The S-record file to parse.
+ * @param[in] outputFile: The report file to write.
+ * @param[in] numberOfValidator: The number of validator threads (1 to SREC_PIPE_MAX_VALIDATOR).
+ * @param[out] None
+ * @param[inout] None
+ * @return: 1 if the file was parsed, 0 otherwise.
+ */
+extern uint8_t ParseSrecPipeline(const char* inputFile, const char* outputFile, uint32_t numberOfValidator);
+
+#endif // !SRECPIPE_H
+
+/*******************************************************************************
+* EOF
+*******************************************************************************/
@@ -0,0 +1,213 @@
+/*******************************************************************************
+* Include
+*******************************************************************************/
+
+#include "srecrepair.h"
+#include "srecmap.h"
+
+/*******************************************************************************
+* Prototype
+*******************************************************************************/
+
+/**
+ * @brief: Repair the fields of one line held in a buffer
+ *
+ * @param[inout] line: The line, without line ending.
+ * @param[in] lengthOfLine: The length of the line.
+ * @param[in] numberOfLine: The line number, for the log.
+ * @param[in] numberOfData: The number of S1/S2/S3 records before the line.
+ * @param[in] isCountKnown: 0 if a line before could not be repaired, so numberOfData can't be trusted.
+ * @param[inout] log: The stream that receives the changes.
+ * @return: 1 if the line is valid after the repair, 0 otherwise.
+ */
+static uint8_t RepairLine(char* line, uint32_t lengthOfLine, uint32_t numberOfLine, uint32_t numberOfData,
+                          uint8_t isCountKnown, FILE* log)
+{
+    SrecTpye stype;
+    uint32_t lengthOfAddress;
+    uint32_t byteCount;
+    uint32_t lineCount;
+    uint32_t index;
+    uint8_t sum;
+    uint8_t value;
+
+    stype = CheckSType(line);
+    lengthOfAddress = GetAddressLength(stype);
+    if (lengthOfAddress == 0)
+    {
+        fprintf(log, "%-10u not repaired: wrong S-type\n", numberOfLine);
+        return 0;
+    }
+
+    if (CheckHexaLine(line + 1, lengthOfLine - 1) != 1)
+    {
+        fprintf(log, "%-10u not repaired: non-hexadecimal character\n", numberOfLine);
+        return 0;
+    }
+
+    /* A byte count not matching the line length means a lost or extra byte, which can't be repaired */
+    byteCount = (lengthOfLine - 4) / 2;
+    if (((lengthOfLine % 2) != 0) || (lengthOfLine < 4) || (byteCount < (lengthOfAddress + 1)) || (byteCount > MAX_BYTE_COUNT))
+    {
+        fprintf(log, "%-10u not repaired: line length %u\n", numberOfLine, lengthOfLine);
+        return 0;
+    }
+
+    value = ReadSrecHexByte(&line[2]);
+    if (value != byteCount)
+    {
+        fprintf(log, "%-10u not repaired: byte count %02X, line holds %02X bytes\n", numberOfLine, value, byteCount);
+        return 0;
+    }
+
+    /* S5/S6 count, when the number of data records is known and fits the field */
+    if (((stype == S5) || (stype == S6)) && (isCountKnown == 0))
+    {
+        fprintf(log, "%-10u count not checked: lines before were not repaired\n", numberOfLine);
+    }
+    else if ((stype == S5) || (stype == S6))
+    {
+        lineCount = 0;
+        for (index = 0; index < lengthOfAddress; index++)
+        {
+            lineCount = (lineCount << 8) | ReadSrecHexByte(&line[4 + (index * 2)]);
+        }
+
+        if (lineCount != numberOfData)
+        {
+            if ((numberOfData >> (lengthOfAddress * 8)) != 0)
+            {
+                fprintf(log, "%-10u not repaired: %u records don't fit the S%c count\n", numberOfLine, numberOfData, line[1]);
+                return 0;
+            }
+
+            fprintf(log, "%-10u line count %0*X -> %0*X\n", numberOfLine,
+                    (int)(lengthOfAddress * 2), lineCount, (int)(lengthOfAddress * 2), numberOfData);
+            for (index = 0; index < lengthOfAddress; index++)
+            {
+                WriteSrecHexByte(&line[4 + (index * 2)], (uint8_t)(numberOfData >> ((lengthOfAddress - 1 - index) * 8)));
+            }
+        }
+    }
+
+    /* Checksum over the repaired fields */
+    sum = 0;
+    for (index = 2; index < (lengthOfLine - 2); index += 2)
+    {
+        sum += ReadSrecHexByte(&line[index]);
+    }
+    sum = 0xFF - sum;
+
+    value = ReadSrecHexByte(&line[lengthOfLine - 2]);
+    if (value != sum)
+    {
+        fprintf(log, "%-10u checksum %02X -> %02X\n", numberOfLine, value, sum);
+        WriteSrecHexByte(&line[lengthOfLine - 2], sum);
+    }
+
+    return 1;
+}
+
+/*******************************************************************************
+* Function
+*******************************************************************************/
+
+/**
+ * @brief: Repair the S5/S6 count and checksum fields of an S-record file in place
+ *
+ * @param[in] fileName: The S-record file to repair.
+ * @param[inout] log: The stream that receives the changes.
+ * @return: 1 if every line is valid after the repair, 0 otherwise.
+ */
+extern uint8_t RepairSrec(const char* fileName, FILE* log)
+{
+    char line[LENGTH_OF_LINE];
+    SrecMap map;
+    SrecTpye stype;
+    size_t position;
+    size_t end;
+    uint32_t lengthOfLine;
+    uint32_t numberOfLine;
+    uint32_t numberOfData;
+    uint32_t numberOfRepaired;
+    uint32_t numberOfFailed;
+    uint8_t isCountKnown;
+    uint8_t Flag;
+
+    if (OpenSrecMap(&map, fileName, 1) != 1)
+    {
+        perror("ERROR: Can't map this file");
+        return 0;
+    }
+
+    Flag = 1;
+    position = 0;
+    numberOfLine = 0;
+    numberOfData = 0;
+    numberOfRepaired = 0;
+    numberOfFailed = 0;
+    isCountKnown = 1;
+
+    while (position < map.size)
+    {
+        /* Find the end of the line, without its line ending */
+        end = position;
+        while ((end < map.size) && (map.data[end] != '\n'))
+        {
+            end++;
+        }
+        lengthOfLine = (uint32_t)(end - position);
+        if ((lengthOfLine > 0) && (map.data[end - 1] == '\r'))
+        {
+            lengthOfLine--;
+        }
+        numberOfLine++;
+
+        if (lengthOfLine >= LENGTH_OF_LINE)
+        {
+            fprintf(log, "%-10u not repaired: line too long\n", numberOfLine);
+            numberOfFailed++;
+            isCountKnown = 0;
+        }
+        else if (lengthOfLine > 0)
+        {
+            memcpy(line, &map.data[position], lengthOfLine);
+            line[lengthOfLine] = '\0';
+
+            if (RepairLine(line, lengthOfLine, numberOfLine, numberOfData, isCountKnown, log) != 1)
+            {
+                numberOfFailed++;
+                isCountKnown = 0;  /* The line may be a data record, the count is unknown from here */
+            }
+            else if (memcmp(line, &map.data[position], lengthOfLine) != 0)
+            {
+                /* Write back only the modified line */
+                memcpy(&map.data[position], line, lengthOfLine);
+                if (FlushSrecMap(&map, position, lengthOfLine) != 1)
+                {
+                    perror("ERROR: Can't write the repaired line");
+                    Flag = 0;
+                }
+                numberOfRepaired++;
+            }
+
+            stype = CheckSType(line);
+            if ((stype == S1) || (stype == S2) || (stype == S3))
+            {
+                numberOfData++;
+            }
+        }
+
+        position = end + 1;
+    }
+
+    fprintf(log, "Repaired %u lines, %u lines not repaired\n", numberOfRepaired, numberOfFailed);
+
+    CloseSrecMap(&map);
+
+    return ((Flag == 1) && (numberOfFailed == 0)) ? 1 : 0;
+}
+
+/*******************************************************************************
+* EOF
+*******************************************************************************/
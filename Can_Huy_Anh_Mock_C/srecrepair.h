@@ -0,0 +1,34 @@
+/*******************************************************************************
+* Include
+*******************************************************************************/
+
+#pragma once
+#ifndef SRECREPAIR_H
+#define SRECREPAIR_H
+#include "sreclib.h"
+
+/*******************************************************************************
+* API
+*******************************************************************************/
+
+/**
+ * @brief: To repair the S5/S6 count and checksum fields of an S-record file in place
+ *
+ * This function maps the file read-write and rewrites only the characters of the fields that are wrong,
+ * keeping every line length. The S5/S6 count is set from the number of data records before it when it fits
+ * the field and every line before was repaired, then the checksum is recomputed. A byte count not matching
+ * the line length is a lost or extra byte and is not repaired. Only the pages of the modified lines are
+ * written back. Every change, and every invalid line that can't be repaired, is logged.
+ *
+ * @param[in] fileName: The S-record file to repair.
+ * @param[out] None
+ * @param[inout] log: The stream that receives the changes.
+ * @return: 1 if every line is valid after the repair, 0 otherwise.
+ */
+extern uint8_t RepairSrec(const char* fileName, FILE* log);
+
+#endif // !SRECREPAIR_H
+
+/*******************************************************************************
+* EOF
+*******************************************************************************/
@@ -0,0 +1,95 @@
+/*******************************************************************************
+* Include
+*******************************************************************************/
+
+#pragma once
+#ifndef SRECRING_H
+#define SRECRING_H
+#include <stdint.h>
+#include <stdatomic.h>
+#include <threads.h>
+
+#define SREC_RING_SIZE      64          /* Slots of a ring buffer, power of two */
+#define SREC_RING_END       UINT32_MAX  /* Slot value telling the consumer that nothing more will come */
+#define SREC_RING_CACHELINE 64          /* Padding to keep producer and consumer indexes on separate cache lines */
+
+/*******************************************************************************
+* Struct
+*******************************************************************************/
+
+/**
+ * @brief: Bounded lock-free ring buffer of block indexes with one producer and one consumer
+ */
+typedef struct
+{
+    atomic_uint_fast32_t head;                                          /**< Next slot to pop, written by the consumer */
+    char padHead[SREC_RING_CACHELINE - sizeof(atomic_uint_fast32_t)];   /**< Padding */
+    atomic_uint_fast32_t tail;                                          /**< Next slot to push, written by the producer */
+    char padTail[SREC_RING_CACHELINE - sizeof(atomic_uint_fast32_t)];   /**< Padding */
+    uint32_t slot[SREC_RING_SIZE];                                      /**< Block indexes */
+} SrecRing;
+
+/*******************************************************************************
+* API
+*******************************************************************************/
+
+/**
+ * @brief: To push a block index into a ring, waiting while the ring is full
+ *
+ * Must only be called by the producer of the ring.
+ *
+ * @param[in] value: The block index to push.
+ * @param[out] None
+ * @param[inout] ring: The ring buffer.
+ * @return: None
+ */
+static inline void PushRing(SrecRing* ring, uint32_t value)
+{
+    uint_fast32_t tail;
+
+    tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+    /* Wait for the consumer to free a slot */
+    while ((tail - atomic_load_explicit(&ring->head, memory_order_acquire)) == SREC_RING_SIZE)
+    {
+        thrd_yield();
+    }
+
+    ring->slot[tail & (SREC_RING_SIZE - 1)] = value;
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+}
+
+/**
+ * @brief: To pop a block index from a ring, waiting while the ring is empty
+ *
+ * Must only be called by the consumer of the ring.
+ *
+ * @param[in] None
+ * @param[out] None
+ * @param[inout] ring: The ring buffer.
+ * @return: The block index.
+ */
+static inline uint32_t PopRing(SrecRing* ring)
+{
+    uint_fast32_t head;
+    uint32_t value;
+
+    head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+    /* Wait for the producer to fill a slot */
+    while (atomic_load_explicit(&ring->tail, memory_order_acquire) == head)
+    {
+        thrd_yield();
+    }
+
+    value = ring->slot[head & (SREC_RING_SIZE - 1)];
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+
+    return value;
+}
+
+#endif // !SRECRING_H
+
+/*******************************************************************************
+* EOF
+*******************************************************************************/
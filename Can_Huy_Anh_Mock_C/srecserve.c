@@ -0,0 +1,774 @@
+/*******************************************************************************
+* Include
+*******************************************************************************/
+
+#ifndef _WIN32
+/* POSIX declarations */
+#define _POSIX_C_SOURCE 200809L
+#endif
+#include "srecserve.h"
+#include "srecblock.h"
+#include <stdarg.h>
+#include <stdlib.h>
+#include <time.h>
+#ifdef _WIN32
+#include <winsock2.h>
+#include <afunix.h>
+#pragma comment(lib, "Ws2_32.lib")
+typedef SOCKET SrecSocket;
+typedef WSAPOLLFD SrecPollFd;
+#define SREC_INVALID_SOCKET INVALID_SOCKET
+#define SREC_SEND_FLAGS 0
+#define CloseSocket(socket) closesocket(socket)
+#define PollSockets(fds, count, milliseconds) WSAPoll(fds, (ULONG)(count), milliseconds)
+#else
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+typedef int SrecSocket;
+typedef struct pollfd SrecPollFd;
+#define SREC_INVALID_SOCKET (-1)
+#ifdef MSG_NOSIGNAL
+#define SREC_SEND_FLAGS MSG_NOSIGNAL  /* A client gone away is a send error, not a SIGPIPE */
+#else
+#define SREC_SEND_FLAGS 0             /* SO_NOSIGPIPE is set on the socket instead */
+#endif
+#define CloseSocket(socket) close(socket)
+#define PollSockets(fds, count, milliseconds) poll(fds, (nfds_t)(count), milliseconds)
+#endif
+
+/* Initial size of the file and response buffers */
+#define SREC_SERVE_BUFFER  65536
+/* Time between two checks of the idle clients */
+#define SREC_SERVE_POLL_MS 1000
+
+/*******************************************************************************
+* Struct
+*******************************************************************************/
+
+/**
+ * @brief: A connected client
+ */
+typedef struct
+{
+    SrecSocket socket;                  /**< Socket of the client */
+    char request[SREC_SERVE_REQUEST];   /**< Bytes received from the client */
+    size_t lengthOfRequest;             /**< Number of bytes in request */
+    time_t lastActivity;                /**< Time of the last bytes received */
+} SrecClient;
+
+/**
+ * @brief: Buffers of the server, kept warm between requests
+ */
+typedef struct
+{
+    char* file;                         /**< Content of the requested file */
+    size_t sizeOfFile;                  /**< Allocated size of file */
+    char* response;                     /**< Response being built */
+    size_t sizeOfResponse;              /**< Allocated size of response */
+    size_t lengthOfResponse;            /**< Length of the response */
+    SrecClient client[SREC_SERVE_MAX_CLIENT];  /**< Connected clients */
+    uint32_t numberOfClient;            /**< Number of connected clients */
+    char line[LENGTH_OF_LINE];          /**< Line being validated */
+    SrecRecord record;                  /**< Result of the line being validated */
+} SrecServer;
+
+/*******************************************************************************
+* Prototype
+*******************************************************************************/
+
+/**
+ * @brief: Append formatted text to the response, growing the buffer if needed
+ *
+ * @param[inout] server: The server.
+ * @param[in] format: The printf format.
+ */
+static void AppendResponse(SrecServer* server, const char* format, ...)
+{
+    va_list args;
+    char* grown;
+    int length;
+
+    for (;;)
+    {
+        va_start(args, format);
+        length = vsnprintf(server->response + server->lengthOfResponse,
+                           server->sizeOfResponse - server->lengthOfResponse, format, args);
+        va_end(args);
+
+        if ((length < 0) || ((server->lengthOfResponse + (size_t)length) < server->sizeOfResponse))
+        {
+            break;
+        }
+
+        grown = (char*)realloc(server->response, server->sizeOfResponse * 2);
+        if (grown == NULL)
+        {
+            server->response[server->lengthOfResponse] = '\0';
+            return;  /* Response is truncated */
+        }
+        server->response = grown;
+        server->sizeOfResponse *= 2;
+    }
+
+    if (length > 0)
+    {
+        server->lengthOfResponse += (size_t)length;
+    }
+}
+
+/**
+ * @brief: Read a whole file into the file buffer
+ *
+ * @param[inout] server: The server.
+ * @param[in] fileName: The file to read.
+ * @param[out] lengthOfFile: The number of bytes read.
+ * @return: 1 if the file was read, 0 otherwise.
+ */
+static uint8_t ReadFile(SrecServer* server, const char* fileName, size_t* lengthOfFile)
+{
+    FILE* srecfile;
+    char* grown;
+    size_t length;
+
+    srecfile = fopen(fileName, "rb");
+    if (srecfile == NULL)
+    {
+        return 0;
+    }
+
+    *lengthOfFile = 0;
+    for (;;)
+    {
+        /* Keep room for the terminator */
+        if ((*lengthOfFile + 1) == server->sizeOfFile)
+        {
+            grown = (char*)realloc(server->file, server->sizeOfFile * 2);
+            if (grown == NULL)
+            {
+                fclose(srecfile);
+                return 0;
+            }
+            server->file = grown;
+            server->sizeOfFile *= 2;
+        }
+
+        length = fread(server->file + *lengthOfFile, 1, server->sizeOfFile - 1 - *lengthOfFile, srecfile);
+        if (length == 0)
+        {
+            break;
+        }
+        *lengthOfFile += length;
+    }
+
+    server->file[*lengthOfFile] = '\0';
+    fclose(srecfile);
+
+    return 1;
+}
+
+/**
+ * @brief: Copy the next line of the file buffer into the line buffer, split like fgets
+ *
+ * @param[inout] server: The server.
+ * @param[inout] position: The position of the line in the file buffer, moved past the line.
+ * @param[in] lengthOfFile: The number of bytes in the file buffer.
+ * @return: 1 if a line was copied, 0 at the end of the buffer.
+ */
+static uint8_t NextLine(SrecServer* server, size_t* position, size_t lengthOfFile)
+{
+    size_t consumed;
+    size_t length;
+
+    if (*position >= lengthOfFile)
+    {
+        return 0;
+    }
+
+    consumed = 0;
+    length = 0;
+    while ((length < (LENGTH_OF_LINE - 1)) && ((*position + consumed) < lengthOfFile))
+    {
+        server->line[length] = server->file[*position + consumed];
+        consumed++;
+        length++;
+        if (server->line[length - 1] == '\n')
+        {
+            break;
+        }
+    }
+
+    /* The file is read in binary mode, drop the carriage return of CRLF lines */
+    if ((length >= 2) && (server->line[length - 2] == '\r') && (server->line[length - 1] == '\n'))
+    {
+        server->line[length - 2] = '\n';
+        length--;
+    }
+
+    server->line[length] = '\0';
+    *position += consumed;
+
+    return 1;
+}
+
+/**
+ * @brief: Validate a file like parseSrecord and list its invalid lines
+ *
+ * @param[inout] server: The server.
+ * @param[in] fileName: The S-record file.
+ */
+static void ValidateRequest(SrecServer* server, const char* fileName)
+{
+    char summary[64];
+    size_t lengthOfFile;
+    size_t position;
+    size_t startOfList;
+    uint32_t numberOfType[3];
+    uint32_t numberOfData;
+    uint32_t numberOfInvalid;
+    DataRecordType typeOfData;
+    SrecTpye stype;
+
+    if (ReadFile(server, fileName, &lengthOfFile) != 1)
+    {
+        AppendResponse(server, "ERROR can't read %s\n", fileName);
+        return;
+    }
+
+    /* First pass: data record type, like CheckDataRecord */
+    numberOfType[0] = 0;
+    numberOfType[1] = 0;
+    numberOfType[2] = 0;
+    position = 0;
+    while (NextLine(server, &position, lengthOfFile) == 1)
+    {
+        stype = CheckSType(server->line);
+        if ((stype == S1) || (stype == S2) || (stype == S3))
+        {
+            numberOfType[stype - S1]++;
+        }
+    }
+    typeOfData = SelectDataRecord(numberOfType[0], numberOfType[1], numberOfType[2]);
+
+    /* Second pass: validate every line, the summary is written in front of the list once known */
+    AppendResponse(server, "OK lines=%010u data=%010u invalid=%010u\n", 0u, 0u, 0u);
+    startOfList = server->lengthOfResponse;
+    server->record.numberOfLine = 0;
+    numberOfData = 0;
+    numberOfInvalid = 0;
+    position = 0;
+    while (NextLine(server, &position, lengthOfFile) == 1)
+    {
+        server->record.numberOfLine++;
+        server->record.numberOfData = numberOfData;
+
+        stype = CheckSType(server->line);
+        if ((stype == S1) || (stype == S2) || (stype == S3))
+        {
+            numberOfData++;
+        }
+
+        CheckSrecRecord(server->line, typeOfData, &server->record);
+        if (strcmp(server->record.errorMessage, "Valid") != 0)
+        {
+            AppendResponse(server, "%u %s\n", server->record.numberOfLine, server->record.errorMessage);
+            numberOfInvalid++;
+        }
+    }
+
+    /* Fixed-width fields keep the summary length, rewrite it in place */
+    snprintf(summary, sizeof(summary), "OK lines=%010u data=%010u invalid=%010u\n",
+             server->record.numberOfLine, numberOfData, numberOfInvalid);
+    memcpy(server->response, summary, startOfList);
+}
+
+/**
+ * @brief: List the contiguous address ranges covered by the valid data records of a file
+ *
+ * @param[inout] server: The server.
+ * @param[in] fileName: The S-record file.
+ */
+static void IndexRequest(SrecServer* server, const char* fileName)
+{
+    char summary[64];
+    SrecData decoded;
+    size_t lengthOfFile;
+    size_t position;
+    size_t startOfList;
+    uint32_t numberOfRange;
+    uint32_t firstAddress;
+    uint64_t endAddress;
+
+    if (ReadFile(server, fileName, &lengthOfFile) != 1)
+    {
+        AppendResponse(server, "ERROR can't read %s\n", fileName);
+        return;
+    }
+
+    AppendResponse(server, "OK ranges=%010u\n", 0u);
+    startOfList = server->lengthOfResponse;
+    numberOfRange = 0;
+    firstAddress = 0;
+    endAddress = 0;
+    position = 0;
+
+    while (NextLine(server, &position, lengthOfFile) == 1)
+    {
+        if ((DecodeSrecLine(server->line, &decoded) != 1) || (decoded.lengthOfData == 0) ||
+            ((decoded.type != S1) && (decoded.type != S2) && (decoded.type != S3)))
+        {
+            continue;
+        }
+
+        /* Extend the open range or start a new one, in file order */
+        if ((numberOfRange > 0) && (decoded.address == endAddress))
+        {
+            endAddress += decoded.lengthOfData;
+        }
+        else
+        {
+            if (numberOfRange > 0)
+            {
+                AppendResponse(server, "%08X-%08X\n", firstAddress, (uint32_t)(endAddress - 1));
+            }
+            numberOfRange++;
+            firstAddress = decoded.address;
+            endAddress = (uint64_t)decoded.address + decoded.lengthOfData;
+        }
+    }
+
+    if (numberOfRange > 0)
+    {
+        AppendResponse(server, "%08X-%08X\n", firstAddress, (uint32_t)(endAddress - 1));
+    }
+
+    snprintf(summary, sizeof(summary), "OK ranges=%010u\n", numberOfRange);
+    memcpy(server->response, summary, startOfList);
+}
+
+/**
+ * @brief: Answer one request line
+ *
+ * @param[inout] server: The server.
+ * @param[inout] request: The request line, without newline, split in place.
+ * @return: 1 if the server must stop, 0 otherwise.
+ */
+static uint8_t HandleRequest(SrecServer* server, char* request)
+{
+    char* argument;
+    char* inputFile;
+    char* outputFile;
+    uint8_t Flag;
+
+    Flag = 0;
+    server->lengthOfResponse = 0;
+    server->response[0] = '\0';
+
+    /* The command ends at the first space, the rest are its arguments */
+    argument = strchr(request, ' ');
+    if (argument != NULL)
+    {
+        *argument = '\0';
+        argument++;
+    }
+
+    if ((strcmp(request, "VALIDATE") == 0) && (argument != NULL))
+    {
+        ValidateRequest(server, argument);
+    }
+    else if ((strcmp(request, "INDEX") == 0) && (argument != NULL))
+    {
+        IndexRequest(server, argument);
+    }
+    else if ((strcmp(request, "CONVERT") == 0) && (argument != NULL))
+    {
+        /* <bytes> <input> <output> */
+        inputFile = strchr(argument, ' ');
+        outputFile = (inputFile != NULL) ? strchr(inputFile + 1, ' ') : NULL;
+        if (outputFile == NULL)
+        {
+            AppendResponse(server, "ERROR convert needs <bytes> <input> <output>\n");
+        }
+        else
+        {
+            *inputFile++ = '\0';
+            *outputFile++ = '\0';
+            if (ReblockSrec(inputFile, outputFile, (uint32_t)strtoul(argument, NULL, 10)) == 1)
+            {
+                AppendResponse(server, "OK\n");
+            }
+            else
+            {
+                AppendResponse(server, "ERROR convert %s failed\n", inputFile);
+            }
+        }
+    }
+    else if (strcmp(request, "SHUTDOWN") == 0)
+    {
+        AppendResponse(server, "OK\n");
+        Flag = 1;
+    }
+    else
+    {
+        AppendResponse(server, "ERROR unknown request\n");
+    }
+
+    AppendResponse(server, "END\n");
+
+    return Flag;
+}
+
+/**
+ * @brief: Get the current time in milliseconds
+ *
+ * @return: The time in milliseconds.
+ */
+static int64_t GetMilliseconds(void)
+{
+    struct timespec now;
+
+    timespec_get(&now, TIME_UTC);
+
+    return ((int64_t)now.tv_sec * 1000) + (now.tv_nsec / 1000000);
+}
+
+/**
+ * @brief: Limit the time a send call may block on a socket
+ *
+ * @param[in] socket: The socket.
+ * @param[in] milliseconds: The time limit, at least 1.
+ */
+static void SetSendTimeout(SrecSocket socket, int64_t milliseconds)
+{
+#ifdef _WIN32
+    DWORD timeout = (DWORD)milliseconds;
+#else
+    struct timeval timeout;
+
+    timeout.tv_sec = (time_t)(milliseconds / 1000);
+    timeout.tv_usec = (suseconds_t)((milliseconds % 1000) * 1000);
+#endif
+
+    setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, (const char*)&timeout, sizeof(timeout));
+}
+
+/**
+ * @brief: Send the whole response to the client within SREC_SERVE_SEND_SECONDS
+ *
+ * The deadline covers the whole response, so a client reading a few bytes at a time can't hold the server.
+ *
+ * @param[in] client: The client socket.
+ * @param[in] server: The server.
+ * @return: 1 if the response was sent, 0 otherwise.
+ */
+static uint8_t SendResponse(SrecSocket client, const SrecServer* server)
+{
+    int64_t deadline;
+    int64_t remaining;
+    size_t sent;
+    int length;
+
+    deadline = GetMilliseconds() + (SREC_SERVE_SEND_SECONDS * 1000);
+
+    for (sent = 0; sent < server->lengthOfResponse; sent += (size_t)length)
+    {
+        remaining = deadline - GetMilliseconds();
+        if (remaining <= 0)
+        {
+            return 0;  /* Client not reading its response */
+        }
+        SetSendTimeout(client, remaining);
+
+        length = (int)send(client, server->response + sent, (int)(server->lengthOfResponse - sent), SREC_SEND_FLAGS);
+        if (length <= 0)
+        {
+            return 0;  /* Client gone (EPIPE) or not reading its response */
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * @brief: Receive the bytes sent by a client and answer every complete request
+ *
+ * @param[inout] server: The server.
+ * @param[inout] client: The client, its socket is readable.
+ * @param[out] stop: Set to 1 when the client asks the server to shut down.
+ * @return: 1 to keep the connection, 0 if the client disconnected.
+ */
+static uint8_t ReceiveClient(SrecServer* server, SrecClient* client, uint8_t* stop)
+{
+    char* newline;
+    size_t lengthOfLine;
+    int length;
+
+    if (client->lengthOfRequest == SREC_SERVE_REQUEST)
+    {
+        client->lengthOfRequest = 0;  /* Drop a request that is too long */
+    }
+
+    length = (int)recv(client->socket, client->request + client->lengthOfRequest,
+                       (int)(SREC_SERVE_REQUEST - client->lengthOfRequest), 0);
+    if (length <= 0)
+    {
+        return 0;  /* Client disconnected */
+    }
+    client->lengthOfRequest += (size_t)length;
+    client->lastActivity = time(NULL);
+
+    /* Answer every complete request already received */
+    while ((*stop == 0) &&
+           ((newline = (char*)memchr(client->request, '\n', client->lengthOfRequest)) != NULL))
+    {
+        *newline = '\0';
+        lengthOfLine = (size_t)(newline - client->request);
+        if ((lengthOfLine > 0) && (client->request[lengthOfLine - 1] == '\r'))
+        {
+            client->request[lengthOfLine - 1] = '\0';
+        }
+
+        *stop = HandleRequest(server, client->request);
+        if (SendResponse(client->socket, server) != 1)
+        {
+            return 0;
+        }
+
+        client->lengthOfRequest -= lengthOfLine + 1;
+        memmove(client->request, newline + 1, client->lengthOfRequest);
+    }
+
+    return 1;
+}
+
+/**
+ * @brief: Accept a new client and set up its socket
+ *
+ * @param[inout] server: The server, with room for one more client.
+ * @param[in] listener: The listening socket, readable.
+ */
+static void AcceptClient(SrecServer* server, SrecSocket listener)
+{
+    SrecClient* client;
+    SrecSocket accepted;
+
+    accepted = accept(listener, NULL, NULL);
+    if (accepted == SREC_INVALID_SOCKET)
+    {
+        return;
+    }
+
+#if !defined(_WIN32) && !defined(MSG_NOSIGNAL) && defined(SO_NOSIGPIPE)
+    {
+        int noSignal = 1;
+        setsockopt(accepted, SOL_SOCKET, SO_NOSIGPIPE, &noSignal, sizeof(noSignal));
+    }
+#endif
+
+    client = &server->client[server->numberOfClient++];
+    client->socket = accepted;
+    client->lengthOfRequest = 0;
+    client->lastActivity = time(NULL);
+}
+
+/**
+ * @brief: Remove a socket file left by a previous server, refusing to remove anything else
+ *
+ * @param[in] socketPath: The path of the socket.
+ * @return: 1 if nothing is left at the path, 0 if another kind of file is there.
+ */
+static uint8_t RemoveStaleSocket(const char* socketPath)
+{
+#ifdef _WIN32
+    DWORD attributes = GetFileAttributesA(socketPath);
+
+    if (attributes == INVALID_FILE_ATTRIBUTES)
+    {
+        return 1;
+    }
+    /* Unix domain sockets are reparse points on Windows */
+    if ((attributes & FILE_ATTRIBUTE_REPARSE_POINT) == 0)
+    {
+        return 0;
+    }
+    return (DeleteFileA(socketPath) != 0) ? 1 : 0;
+#else
+    struct stat status;
+
+    if (lstat(socketPath, &status) != 0)
+    {
+        return 1;
+    }
+    if (!S_ISSOCK(status.st_mode))
+    {
+        return 0;
+    }
+    return (unlink(socketPath) == 0) ? 1 : 0;
+#endif
+}
+
+/*******************************************************************************
+* Function
+*******************************************************************************/
+
+/**
+ * @brief: Serve validation requests over a local Unix domain socket
+ *
+ * @param[in] socketPath: The path of the socket.
+ * @return: 1 if the server stopped on SHUTDOWN, 0 if it can't listen.
+ */
+extern uint8_t ServeSrec(const char* socketPath)
+{
+    SrecPollFd fds[SREC_SERVE_MAX_CLIENT + 1];
+    struct sockaddr_un address;
+    SrecServer* server;
+    SrecClient* client;
+    SrecSocket listener;
+    uint32_t numberOfFd;
+    uint32_t index;
+    time_t now;
+    uint8_t isListening;
+    uint8_t isOpen;
+    uint8_t Flag;
+#ifdef _WIN32
+    WSADATA wsaData;
+
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+    {
+        fprintf(stderr, "ERROR: Can't start Winsock\n");
+        return 0;
+    }
+#endif
+
+    Flag = 0;
+    isListening = 0;
+    listener = SREC_INVALID_SOCKET;
+    server = (SrecServer*)calloc(1, sizeof(SrecServer));
+    if (server != NULL)
+    {
+        server->file = (char*)malloc(SREC_SERVE_BUFFER);
+        server->sizeOfFile = SREC_SERVE_BUFFER;
+        server->response = (char*)malloc(SREC_SERVE_BUFFER);
+        server->sizeOfResponse = SREC_SERVE_BUFFER;
+    }
+
+    if ((server == NULL) || (server->file == NULL) || (server->response == NULL) ||
+        (strlen(socketPath) >= sizeof(address.sun_path)))
+    {
+        fprintf(stderr, "ERROR: Can't prepare the server\n");
+    }
+    else
+    {
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        strcpy(address.sun_path, socketPath);
+
+        if (RemoveStaleSocket(socketPath) != 1)  /* Replace a socket left by a previous server */
+        {
+            fprintf(stderr, "ERROR: %s exists and is not a socket\n", socketPath);
+        }
+        else
+        {
+            listener = socket(AF_UNIX, SOCK_STREAM, 0);
+            if ((listener == SREC_INVALID_SOCKET) ||
+                (bind(listener, (struct sockaddr*)&address, sizeof(address)) != 0) ||
+                (listen(listener, 16) != 0))
+            {
+                perror("ERROR: Can't listen on the socket");
+                if (listener != SREC_INVALID_SOCKET)
+                {
+                    CloseSocket(listener);
+                    listener = SREC_INVALID_SOCKET;
+                }
+            }
+            else
+            {
+                isListening = 1;
+            }
+        }
+    }
+
+    /* Wait on every client and the listener, requests are answered one at a time with shared buffers */
+    while ((isListening == 1) && (Flag == 0))
+    {
+        for (index = 0; index < server->numberOfClient; index++)
+        {
+            fds[index].fd = server->client[index].socket;
+            fds[index].events = POLLIN;
+            fds[index].revents = 0;
+        }
+        numberOfFd = server->numberOfClient;
+        if (server->numberOfClient < SREC_SERVE_MAX_CLIENT)
+        {
+            /* When full, new clients wait in the listen backlog */
+            fds[numberOfFd].fd = listener;
+            fds[numberOfFd].events = POLLIN;
+            fds[numberOfFd].revents = 0;
+            numberOfFd++;
+        }
+
+        if (PollSockets(fds, numberOfFd, SREC_SERVE_POLL_MS) < 0)
+        {
+            continue;  /* Interrupted */
+        }
+
+        /* Backwards, so a closed client can be replaced by the last one */
+        now = time(NULL);
+        for (index = server->numberOfClient; index-- > 0;)
+        {
+            client = &server->client[index];
+            if ((fds[index].revents & (POLLIN | POLLHUP | POLLERR)) != 0)
+            {
+                isOpen = ReceiveClient(server, client, &Flag);
+            }
+            else
+            {
+                isOpen = ((now - client->lastActivity) < SREC_SERVE_IDLE_SECONDS) ? 1 : 0;
+            }
+
+            if (isOpen == 0)
+            {
+                CloseSocket(client->socket);
+                *client = server->client[--server->numberOfClient];
+            }
+        }
+
+        if ((Flag == 0) && (numberOfFd > server->numberOfClient) &&
+            (fds[numberOfFd - 1].fd == listener) && ((fds[numberOfFd - 1].revents & POLLIN) != 0) &&
+            (server->numberOfClient < SREC_SERVE_MAX_CLIENT))
+        {
+            AcceptClient(server, listener);
+        }
+    }
+
+    if (server != NULL)
+    {
+        for (index = 0; index < server->numberOfClient; index++)
+        {
+            CloseSocket(server->client[index].socket);
+        }
+    }
+    if (listener != SREC_INVALID_SOCKET)
+    {
+        CloseSocket(listener);
+        RemoveStaleSocket(socketPath);
+    }
+    if (server != NULL)
+    {
+        free(server->file);
+        free(server->response);
+        free(server);
+    }
+#ifdef _WIN32
+    WSACleanup();
+#endif
+
+    return Flag;
+}
+
+/*******************************************************************************
+* EOF
+*******************************************************************************/
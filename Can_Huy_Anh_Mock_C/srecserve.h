@@ -0,0 +1,45 @@
+/*******************************************************************************
+* Include
+*******************************************************************************/
+
+#pragma once
+#ifndef SRECSERVE_H
+#define SRECSERVE_H
+#include "sreclib.h"
+
+#define SREC_SERVE_REQUEST      1024  /* Maximum length of a request line */
+#define SREC_SERVE_MAX_CLIENT   64    /* Maximum number of connected clients */
+#define SREC_SERVE_IDLE_SECONDS 60    /* A client silent for this long is disconnected */
+#define SREC_SERVE_SEND_SECONDS 10    /* A client not reading its whole response within this time is disconnected */
+
+/*******************************************************************************
+* API
+*******************************************************************************/
+
+/**
+ * @brief: To serve validation requests over a local Unix domain socket
+ *
+ * This function listens on socketPath and keeps up to SREC_SERVE_MAX_CLIENT clients connected, each client may
+ * send any number of requests on its connection. Requests are answered one at a time in arrival order, so a
+ * long request delays the others. A client idle for SREC_SERVE_IDLE_SECONDS, or not reading its whole response
+ * within SREC_SERVE_SEND_SECONDS, is disconnected. Every request is one line, every response ends with a line "END":
+ *
+ *   VALIDATE <file>                   -> OK lines=<n> data=<n> invalid=<n>, then "<line> <message>" per invalid line
+ *   INDEX <file>                      -> OK ranges=<n>, then "<first>-<last>" per contiguous data range
+ *   CONVERT <bytes> <input> <output>  -> OK, the input is re-blocked into <output> like -reblock
+ *   SHUTDOWN                          -> OK, the server stops
+ *
+ * Errors are answered with "ERROR <reason>". The file and response buffers are kept between requests.
+ *
+ * @param[in] socketPath: The path of the socket, a socket left at this path is replaced, any other file is an error.
+ * @param[out] None
+ * @param[inout] None
+ * @return: 1 if the server stopped on SHUTDOWN, 0 if it can't listen.
+ */
+extern uint8_t ServeSrec(const char* socketPath);
+
+#endif // !SRECSERVE_H
+
+/*******************************************************************************
+* EOF
+*******************************************************************************/
@@ -0,0 +1,199 @@
+/*******************************************************************************
+* Include
+*******************************************************************************/
+
+#include "srecverify.h"
+#include "srecmap.h"
+
+/*******************************************************************************
+* Enum
+*******************************************************************************/
+
+/**
+ * @brief: Enum to store the kind of a reported range
+ */
+typedef enum
+{
+    RANGE_NONE,      /**< No range open */
+    RANGE_MISMATCH,  /**< Bytes differ from the dump */
+    RANGE_OUTSIDE    /**< Bytes are outside the dump */
+} SrecRangeKind;
+
+/*******************************************************************************
+* Struct
+*******************************************************************************/
+
+/**
+ * @brief: State of the verification
+ */
+typedef struct
+{
+    const SrecMap* dump;        /**< Mapped dump */
+    uint32_t baseAddress;       /**< Device address of the first byte of the dump */
+    FILE* output;               /**< Stream receiving the ranges */
+    SrecRangeKind kind;         /**< Kind of the open range */
+    uint64_t firstAddress;      /**< First address of the open range, 64-bit so ranges never wrap */
+    uint64_t lastAddress;       /**< Last address of the open range */
+    uint64_t numberOfByte;      /**< Number of data bytes compared */
+    uint64_t numberOfBad;       /**< Number of bytes mismatching or outside the dump */
+} SrecVerify;
+
+/*******************************************************************************
+* Prototype
+*******************************************************************************/
+
+/**
+ * @brief: Write the open range, if any
+ *
+ * @param[inout] verify: The verification state.
+ */
+static void FlushRange(SrecVerify* verify)
+{
+    if (verify->kind != RANGE_NONE)
+    {
+        fprintf(verify->output, "%-10s %08llX-%08llX %llu bytes\n",
+                (verify->kind == RANGE_MISMATCH) ? "MISMATCH" : "OUTSIDE",
+                (unsigned long long)verify->firstAddress, (unsigned long long)verify->lastAddress,
+                (unsigned long long)(verify->lastAddress - verify->firstAddress + 1));
+        verify->kind = RANGE_NONE;
+    }
+}
+
+/**
+ * @brief: Add a bad byte to the open range, starting a new range if it doesn't extend it
+ *
+ * @param[inout] verify: The verification state.
+ * @param[in] address: The address of the byte.
+ * @param[in] kind: The kind of the byte.
+ */
+static void AddBadByte(SrecVerify* verify, uint64_t address, SrecRangeKind kind)
+{
+    verify->numberOfBad++;
+
+    if ((verify->kind == kind) && (address == (verify->lastAddress + 1)))
+    {
+        verify->lastAddress = address;
+    }
+    else
+    {
+        FlushRange(verify);
+        verify->kind = kind;
+        verify->firstAddress = address;
+        verify->lastAddress = address;
+    }
+}
+
+/**
+ * @brief: Compare the data of a decoded record with the dump
+ *
+ * @param[inout] verify: The verification state.
+ * @param[in] decoded: The decoded S1/S2/S3 record.
+ */
+static void CompareRecord(SrecVerify* verify, const SrecData* decoded)
+{
+    uint64_t address;
+    uint64_t offset;
+    uint32_t index;
+
+    offset = (uint64_t)decoded->address - verify->baseAddress;
+    verify->numberOfByte += decoded->lengthOfData;
+
+    /* Fast path: the whole record is inside the dump and matches */
+    if ((decoded->address >= verify->baseAddress) &&
+        ((offset + decoded->lengthOfData) <= verify->dump->size) &&
+        ((decoded->lengthOfData == 0) || (memcmp(verify->dump->data + offset, decoded->data, decoded->lengthOfData) == 0)))
+    {
+        return;
+    }
+
+    for (index = 0; index < decoded->lengthOfData; index++)
+    {
+        address = (uint64_t)decoded->address + index;
+        if ((address < verify->baseAddress) || ((offset + index) >= verify->dump->size))
+        {
+            AddBadByte(verify, address, RANGE_OUTSIDE);
+        }
+        else if (verify->dump->data[offset + index] != decoded->data[index])
+        {
+            AddBadByte(verify, address, RANGE_MISMATCH);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function
+*******************************************************************************/
+
+/**
+ * @brief: Verify a raw device dump against an S-record file
+ *
+ * @param[in] inputFile: The S-record file.
+ * @param[in] dumpFile: The raw binary dump read back from the device.
+ * @param[in] baseAddress: The device address of the first byte of the dump.
+ * @param[inout] output: The stream that receives the mismatching ranges.
+ * @return: 1 if every data byte matches the dump, 0 otherwise.
+ */
+extern uint8_t VerifySrecDump(const char* inputFile, const char* dumpFile, uint32_t baseAddress, FILE* output)
+{
+    char line[LENGTH_OF_LINE];
+    SrecVerify verify;
+    SrecData decoded;
+    SrecMap dump;
+    uint32_t numberOfLine;
+    uint32_t numberOfInvalid;
+    FILE* srecfile;
+
+    srecfile = fopen(inputFile, "r");
+    if (srecfile == NULL)
+    {
+        perror("ERROR: Can't open this file");
+        return 0;
+    }
+    if (OpenSrecMap(&dump, dumpFile, 0) != 1)
+    {
+        perror("ERROR: Can't map the dump file");
+        fclose(srecfile);
+        return 0;
+    }
+
+    verify.dump = &dump;
+    verify.baseAddress = baseAddress;
+    verify.output = output;
+    verify.kind = RANGE_NONE;
+    verify.firstAddress = 0;
+    verify.lastAddress = 0;
+    verify.numberOfByte = 0;
+    verify.numberOfBad = 0;
+    numberOfLine = 0;
+    numberOfInvalid = 0;
+
+    while (fgets(line, sizeof(line), srecfile) != NULL)
+    {
+        numberOfLine++;
+
+        if (DecodeSrecLine(line, &decoded) != 1)
+        {
+            FlushRange(&verify);
+            fprintf(output, "%-10s line %u\n", "INVALID", numberOfLine);
+            numberOfInvalid++;
+        }
+        else if ((decoded.type == S1) || (decoded.type == S2) || (decoded.type == S3))
+        {
+            CompareRecord(&verify, &decoded);
+        }
+    }
+    FlushRange(&verify);
+
+    fprintf(output, "Compared %llu bytes, %llu bad, %u invalid lines: %s\n",
+            (unsigned long long)verify.numberOfByte, (unsigned long long)verify.numberOfBad, numberOfInvalid,
+            ((verify.numberOfBad == 0) && (numberOfInvalid == 0)) ? "MATCH" : "MISMATCH");
+
+    CloseSrecMap(&dump);
+    fclose(srecfile);
+
+    return ((verify.numberOfBad == 0) && (numberOfInvalid == 0)) ? 1 : 0;
+}
+
+/*******************************************************************************
+* EOF
+*******************************************************************************/
@@ -0,0 +1,34 @@
+/*******************************************************************************
+* Include
+*******************************************************************************/
+
+#pragma once
+#ifndef SRECVERIFY_H
+#define SRECVERIFY_H
+#include "sreclib.h"
+
+/*******************************************************************************
+* API
+*******************************************************************************/
+
+/**
+ * @brief: To verify a raw device dump against an S-record file
+ *
+ * This function maps the dump read-only and, while reading the S-record file, compares the bytes of each data
+ * record with the dump at (address - baseAddress). Mismatching bytes and bytes outside the dump are merged into
+ * address ranges and written to the output, followed by a summary. No image of the file is built.
+ *
+ * @param[in] inputFile: The S-record file.
+ * @param[in] dumpFile: The raw binary dump read back from the device.
+ * @param[in] baseAddress: The device address of the first byte of the dump.
+ * @param[out] None
+ * @param[inout] output: The stream that receives the mismatching ranges.
+ * @return: 1 if every data byte matches the dump, 0 otherwise.
+ */
+extern uint8_t VerifySrecDump(const char* inputFile, const char* dumpFile, uint32_t baseAddress, FILE* output);
+
+#endif // !SRECVERIFY_H
+
+/*******************************************************************************
+* EOF
+*******************************************************************************/